@@ -2,6 +2,21 @@
 //
 // This file contains a program which adds a number of integers in a shared
 // memory array and stores the result in its assigned index
+//
+// A bin_adder launching children times each group, and when a child takes
+// SPECULATE_FACTOR times the SPECULATE_PERCENTILE of recent group times, it
+// launches a backup for the same group, following the policy in speculate.c
+// that simulate also uses. Each child sums into a local variable and
+// publishes it only by setting the winner of its group's task slot, so
+// exactly one attempt's sum is kept. The parent then sends SIGTERM to the
+// other attempt, which stops at its next sleep or before its next critical
+// section rather than dying while holding the log file semaphore. The level
+// ends without waiting for it, so a stopped or descheduled loser can't hold
+// up the level. Each slot is claimed with a token naming its level, so a
+// loser that outlives its level can't claim the slot again in the next one.
+//
+// Children are waited for with a ChildWatch, so a single wakeup reaps every
+// child that finished, and freed slots are refilled before the next wait.
 
 #include <sys/types.h>
 #include <sys/wait.h>
@@ -9,6 +24,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <semaphore.h>
+#include <signal.h>
 #include <errno.h>
 #include <time.h>
 #include <pthread.h>
@@ -18,16 +34,37 @@
 #include "sharedMemory.h"
 #include "shmkey.h"
 #include "constants.h"
-
-/* macro for determining the max of two quantities */
-#define max(x,y) ((x >= y) ? x : y)
+#include "trace.h"
+#include "levels.h"
+#include "tasks.h"
+#include "childWatch.h"
+#include "speculate.h"
+
+/* A group summed by a child, and the attempts at it */
+typedef struct {
+	int index;		// Index of the group's first int
+	int size;		// Number of ints in the group
+	pid_t pids[2];		// Running primary and backup, 0 when not running
+	long launched;		// Time in ms the primary was launched
+	int backedUp;		// 1 once a backup has been launched
+	int done;		// 1 once an attempt's sum was kept
+} Group;
 
 /* Prototypes */
-static void launchChildren(char * argv[], int size, int numGroups, int gap);
+static void launchChildren(char * argv[], int size, int numGroups,
+	int numInts);
 static pid_t launchChild(char * argv[], int index, int size);
+static void reapChild(Group * groups, int oldest, int launched, pid_t pid);
+static int finishGroups(Group * groups, int oldest, int launched,
+	GroupTimes * recent);
+static int launchBackups(char * argv[], Group * groups, int oldest,
+	int launched, GroupTimes * recent, int running);
+static long currentMs();
+static void cancel(int sig);
 static void updateLogFile(pid_t pid, int index, int size);
 static void criticalSection(pid_t pid, int index, int size);
 static void sumInts(int * intArray, int resultIndex, int numInts);
+static int groupSum(int * intArray, int index, int numInts);
 static void leftShiftInts(int * intArray, int numInts, int gap);
 static void logSemaphoreActivity(char * msg);
 
@@ -35,6 +72,11 @@ static void logSemaphoreActivity(char * msg);
 static char * shm = NULL;       	  // Pointer to shared memory region
 static pthread_mutex_t * sem = NULL;      // Semaehore protecting logFile
 static pthread_mutex_t * semLgSem = NULL; // Sem protecting sem activity log
+static TaskSlot * tasks = NULL;		  // Task slots, indexed by SLOT
+static int level = 0;			  // Size of the level being summed
+static key_t shmKey = SHMKEY;		  // Key of the shared memory region
+static ChildWatch watch;		  // Reports children that finished
+static volatile sig_atomic_t cancelled = 0; // Set by SIGTERM from the parent
 
 int main(int argc, char * argv[]){
 	int * intArray;			// Pointer to the shared int array
@@ -45,29 +87,29 @@ int main(int argc, char * argv[]){
 	int shmSize = atoi(argv[3]);	// Size of the shared memory region
 
 	exeName = argv[0];
+	traceInit(index);
+
+	// Uses the shared memory key of a master in worker mode if given
+	if (argc > 4) shmKey = (key_t)atoi(argv[4]);
+	setSharedMemoryKey(shmKey);
+
+	// Children are told the size of their level, and parents sum one
+	level = index < 0 ? size : argc > 5 ? atoi(argv[5]) : 0;
 
 	// Gets pointers to shared memory items
 	shm = sharedMemory(shmSize, 0);
 	sem = (pthread_mutex_t *)(shm);
 	semLgSem = (pthread_mutex_t *)(shm + sizeof(pthread_mutex_t));
 	intArray = (int *)(shm + 2 * sizeof(pthread_mutex_t));
+	tasks = taskSlots(shm, shmSize);
 
 	// Launches children if called with -1 or -2 as an index by master
 	if (index < 0){
 		int numGroups; // The number of groups of ints to add
 		int groupSize; // The number of ints per group
 
-		// Computes values for method 1
-		if (index == -1) {
-			numGroups = (int)ceil(size/2.0);
-			groupSize = 2;
-
-		// Computes values for method 2
-		} else if (index == -2) {
-			numGroups = \
-				(int)ceil(size/log((double)size)/log(2.0));
-			groupSize = (int)ceil(log((double)size)/log(2.0));
-		}
+		// Computes values for method 1 or 2
+		numGroups = levelGroups(index, size, &groupSize);
 
 		// Creates child bin_adders
 		launchChildren(argv, size, numGroups, groupSize);
@@ -76,55 +118,215 @@ int main(int argc, char * argv[]){
 		sumInts(intArray, 0, groupSize);
 		leftShiftInts(intArray, size, groupSize);
 
+		// Writes to log, accessing critical section at most 5 times
+		updateLogFile(pid, index, size);
+
 	// Performs computation if this process is a child of a bin_adder		
 	} else {
-		sumInts(intArray, index, size);
+		struct sigaction sigact;	// Stops this attempt on SIGTERM
+		int sum;			// Kept only if this attempt wins
+
+		sigact.sa_handler = cancel;
+		sigact.sa_flags = 0;
+		if ((sigemptyset(&sigact.sa_mask) == -1)
+		    ||(sigaction(SIGTERM, &sigact, NULL) == -1))
+			perrorExit("Failed to install SIGTERM handler");
+
+		// Sums without writing, since a backup may read the same ints
+		sum = groupSum(intArray, index, size);
+
+#ifdef STRAGGLER
+		// Stops the first attempt at index STRAGGLER so check.sh can
+		// test backups. Only that attempt moves progress off 0 this way.
+		if (index == STRAGGLER && __sync_bool_compare_and_swap(
+			&tasks[SLOT(index)].progress, 0, -1))
+			raise(SIGSTOP);
+#endif
+
+		// Writes to log, accessing critical section at most 5 times
+		updateLogFile(pid, index, size);
+
+		// Publishes the sum unless cancelled, beaten by another attempt,
+		// or outlived by this level
+		if (!cancelled && __sync_bool_compare_and_swap(
+			&tasks[SLOT(index)].winner, UNCLAIMED(level), pid)){
+			intArray[index] = sum;
+#ifdef STRAGGLER
+			fprintf(stderr, "%s: %d published index %d\n",
+				exeName, pid, index);
+#endif
+		}
 	}
 	
-	// Writes to log, accessing critical section at most 5 times
-	updateLogFile(pid, index, size);
-	
 	return 0;
 
 }
 
 // Launches numGroups-1 children which each sum numInts integers & store @ index
+// The parent sums group 0 itself, and the last child sums whatever remains
 static void launchChildren(char * argv[], int size, int numGroups, int numInts){
-	int index = numInts;	 // Stores index of each child process
+	Group * groups;		 // The groups summed by children
+	int numChildren = numGroups - 1; // The number of groups children sum
+	int launched = 0;	 // The number of groups launched so far
+	int finished = 0;	 // The number of groups whose sum was kept
+	int oldest = 0;		 // The first group that may have a running child
 	int running = 0;	 // The number of children currently executing
-	int completed = 0;	 // The number of children that finished
-	pid_t pid = 0;		 // Temp storage for child pids
-
-	while (running + completed < numGroups){
+	GroupTimes recent;	 // Ms taken by recently finished groups
+	pid_t pids[MAX_PROCESSES]; // Children reaped in one wakeup
+	int numReaped;		 // The number of children in pids
+	int i;
 
-		// Checks for numInts change on last iteration for method 2
-		if (running + completed == numGroups - 1)
-			numInts = max(size - numGroups * numInts, 2);
+	if (numChildren <= 0) return;
+
+	if ((groups = malloc(numChildren * sizeof(Group))) == NULL)
+		perrorExit("launchChildren couldn't allocate groups");
+	recent.numTimes = 0;
+
+	// Assigns each group its ints and clears its task slot
+	for (i = 0; i < numChildren; i++){
+		groups[i].index = numInts * (i + 1);
+		groups[i].size = i == numChildren - 1
+			? size - groups[i].index : numInts;
+		groups[i].pids[0] = groups[i].pids[1] = 0;
+		groups[i].backedUp = groups[i].done = 0;
+		tasks[SLOT(groups[i].index)].winner = UNCLAIMED(level);
+		tasks[SLOT(groups[i].index)].progress = 0;
+	}
 
-		// Creates bin_adder child with new index and size
-		launchChild(argv, index, numInts);
+	openChildWatch(&watch);
 
-		// Updates index and number of running children	
-		index += numInts;
-		running++;
+	// Ends the level once every group's sum is kept, leaving cancelled
+	// losers to exit on their own
+	while (finished < numChildren){
 
-		// Waits if maximum simultaneous processes reached
-		if (running == MAX_RUNNING){
-			
-			// Waits for child to finish
-			while ((pid = wait(NULL)) == -1 && errno == EINTR);
+		// Launches groups while fewer than MAX_RUNNING children run
+		while (launched < numChildren && running < MAX_RUNNING){
+			groups[launched].pids[0] = launchChild(argv,
+				groups[launched].index, groups[launched].size);
+			groups[launched].launched = currentMs();
+			launched++;
+			running++;
+		}
 
-			// Updates number of running and completed children
-			running--;
-			completed++;
+		// Waits for children to finish or for the next straggler check,
+		// then reaps every child that finished
+		numReaped = reapChildren(&watch, SPECULATE_TICK_MS, pids,
+			MAX_PROCESSES);
+		for (i = 0; i < numReaped; i++)
+			reapChild(groups, oldest, launched, pids[i]);
+		running -= numReaped;
+
+		// Keeps finished groups' sums and relaunches any that were lost
+		// while fewer than MAX_RUNNING children run, timing each afresh
+		// so it can be backed up again
+		finished += finishGroups(groups, oldest, launched, &recent);
+		for (i = oldest; i < launched && running < MAX_RUNNING; i++){
+			if (groups[i].done || groups[i].pids[0] != 0
+			    || groups[i].pids[1] != 0)
+				continue;
+
+			groups[i].pids[0] = launchChild(argv, groups[i].index,
+				groups[i].size);
+			groups[i].launched = currentMs();
+			groups[i].backedUp = 0;
+			running++;
 		}
+
+		// Skips past groups with nothing left running
+		while (oldest < launched && groups[oldest].done
+		    && groups[oldest].pids[0] == 0 && groups[oldest].pids[1] == 0)
+			oldest++;
+
+		running += launchBackups(argv, groups, oldest, launched,
+			&recent, running);
+	}
+
+	closeChildWatch(&watch);
+	free(groups);
+}
+
+// Marks a reaped child as no longer running
+static void reapChild(Group * groups, int oldest, int launched, pid_t pid){
+	int i, attempt;
+
+	for (i = oldest; i < launched; i++)
+		for (attempt = 0; attempt < 2; attempt++)
+			if (groups[i].pids[attempt] == pid){
+				groups[i].pids[attempt] = 0;
+				return;
+			}
+}
+
+// Marks groups whose sum was kept as done once the winner has exited, since
+// it stores its sum after claiming the slot, records how long they took, and
+// cancels the losing attempt. Returns the number of groups newly done.
+static int finishGroups(Group * groups, int oldest, int launched,
+	GroupTimes * recent){
+	int newlyDone = 0;
+	pid_t winner;
+	int i, attempt;
+
+	for (i = oldest; i < launched; i++){
+		winner = tasks[SLOT(groups[i].index)].winner;
+		if (groups[i].done || winner <= 0 || groups[i].pids[0] == winner
+		    || groups[i].pids[1] == winner)
+			continue;
+
+		groups[i].done = 1;
+		newlyDone++;
+		recordGroupTime(recent, currentMs() - groups[i].launched);
+
+		for (attempt = 0; attempt < 2; attempt++)
+			if (groups[i].pids[attempt] != 0)
+				kill(groups[i].pids[attempt], SIGTERM);
 	}
 
-	// Waits for running child processes to finish
-	while (running > 0){
-		while ((pid = wait(NULL)) == -1 && errno == EINTR);
-		running--;
+	return newlyDone;
+}
+
+// Launches a backup for each straggling group while fewer than MAX_RUNNING
+// children run, returning the number launched
+static int launchBackups(char * argv[], Group * groups, int oldest,
+	int launched, GroupTimes * recent, int running){
+	long threshold;		// Ms after which a group is a straggler
+	long now = currentMs();
+	int backups = 0;
+	int i;
+
+	if ((threshold = stragglerThreshold(recent)) == -1) return 0;
+
+	for (i = oldest; i < launched && running + backups < MAX_RUNNING; i++){
+
+		// Skips groups that are done, backed up, fast, or nearly finished
+		if (groups[i].done || groups[i].backedUp
+		    || groups[i].pids[0] == 0
+		    || !needsBackup(threshold, now - groups[i].launched,
+			tasks[SLOT(groups[i].index)].progress))
+			continue;
+
+		fprintf(stderr, "%s: launching backup for index %d after %ld ms\n",
+			exeName, groups[i].index, now - groups[i].launched);
+
+		groups[i].pids[1] = launchChild(argv, groups[i].index,
+			groups[i].size);
+		groups[i].backedUp = 1;
+		backups++;
 	}
+
+	return backups;
+}
+
+// Returns the monotonic time in milliseconds
+static long currentMs(){
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+// Handles SIGTERM, sent when another attempt at this group won
+static void cancel(int sig){
+	cancelled = 1;
 }
 
 // Launches a single child bin_adder
@@ -132,22 +334,36 @@ static pid_t launchChild(char * argv[], int index, int size){
 	pid_t pid;			// Returned pid
 	char sizeBuff[BUFF_SZ];		// Char buff for size
 	char indexBuff[BUFF_SZ];	// Char buff for index
+	char keyBuff[BUFF_SZ];		// Char buff for the shared memory key
+	char levelBuff[BUFF_SZ];	// Char buff for the level's size
+	char * childArgv[] = { argv[0], indexBuff, sizeBuff, argv[3], keyBuff,
+		levelBuff, NULL };
 
 	// Sets index argument for new child
 	sprintf(indexBuff, "%d", index);
-	argv[1] = indexBuff;
 
 	// Sets size argument for new child
 	sprintf(sizeBuff, "%d", size);
-	argv[2] = sizeBuff;
+
+	// Passes on the key, and the level that names the task slot's token
+	sprintf(keyBuff, "%d", (int)shmKey);
+	sprintf(levelBuff, "%d", level);
 
 	if ((pid = fork()) == -1) perrorExit("Failed to fork");
 
 	if (pid == 0){
-		execv(CHILD_PATH, argv);
+		sigset_t sigchld;
+
+		// Unblocks SIGCHLD, which a signalfd child watch blocks
+		sigemptyset(&sigchld);
+		sigaddset(&sigchld, SIGCHLD);
+		sigprocmask(SIG_UNBLOCK, &sigchld, NULL);
+
+		execv(CHILD_PATH, childArgv);
 		perrorExit("Faild to exec child");
 	}
 
+	watchChild(&watch, pid);
 	return pid;
 }
 
@@ -161,10 +377,11 @@ static void updateLogFile(pid_t pid, int index, int size){
 	
 	// Follows the template provided in the assignment description
 	int i;
-	for (i = 0; i < 5; i++){
+	for (i = 0; i < LOG_UPDATES && !cancelled; i++){
 
 		// Sleeps for random ammount of time (between 0 and 3 seconds)	
 		sleep(random() % (MAX_SLEEP - MIN_SLEEP + 1) + MIN_SLEEP);
+		if (cancelled) break;
 
 		// Prints semaphore activity to stderr and log
 		current_time = time(NULL);
@@ -177,13 +394,21 @@ static void updateLogFile(pid_t pid, int index, int size){
 		logSemaphoreActivity(msgBuff);
 
 		// Waits for semaphore
+		traceEvent(TRACE_WAIT, index, TRACE_LOG_LOCK);
 		pthread_mutex_lock(sem);
+		traceEvent(TRACE_ACQUIRE, index, TRACE_LOG_LOCK);
 
-		/* Critical section */
-		criticalSection(pid, index, size);
+		/* Critical section, skipped if cancelled while waiting */
+		if (!cancelled) criticalSection(pid, index, size);
 
 		// Signals semaphore
 		pthread_mutex_unlock(sem);
+		traceEvent(TRACE_RELEASE, index, TRACE_LOG_LOCK);
+
+		// Records progress for the parent's straggler checks
+		if (index >= 0 && tasks[SLOT(index)].winner == UNCLAIMED(level)
+		    && tasks[SLOT(index)].progress < i + 1)
+			tasks[SLOT(index)].progress = i + 1;
 	}
 }
 
@@ -211,6 +436,16 @@ static void criticalSection(pid_t pid, int index, int size){
 	fclose(logFile);
 }
 
+// Returns the sum of numInts ints starting at index without changing them
+static int groupSum(int * intArray, int index, int numInts){
+	int sum = 0;
+	int i = 0;
+	for (; i < numInts; i++){
+		sum += intArray[index + i];
+	}
+	return sum;
+}
+
 // Stores sum of ints from resultIndex to resultIndex + numInts at resultIndex
 static void sumInts(int * intArray, int resultIndex, int numInts){
 	int i = 1;
@@ -235,8 +470,10 @@ static void leftShiftInts(int * intArray, int size, int gap){
 
 }
 
-// Logs when process waits for or aquires a semaphore
+// Logs when process waits for or aquires a semaphore. With -DTRACE the binary
+// trace records these events instead, so semaphore_log isn't written.
 static void logSemaphoreActivity(char * msg){
+#ifndef TRACE
 	FILE * semLog;
 
 	// Protects access to semaphore log file
@@ -254,5 +491,5 @@ static void logSemaphoreActivity(char * msg){
 
 	// Signals semaphore log semaphore
 	pthread_mutex_unlock(semLgSem);
+#endif
 }
-
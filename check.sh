@@ -0,0 +1,297 @@
+#!/bin/sh
+# check.sh was created on 10/19/2026
+#
+# This script builds master and bin_adder with -DNOSLEEP for each summation
+# method and compares the sum master prints with the 64-bit sum randomTestGen
+# prints for inputs chosen to reach the edge cases of both methods: tiny and
+# odd sizes that rely on the zero leftShiftInts appends, sizes whose lg(n) is
+# not a power of two, sizes near multiples of MAX_RUNNING, negative values,
+# values large enough that the sum nearly overflows an int, and packed inputs,
+# including one whose index would point past the end of the file.
+# M1 also runs coordinator against two master -w workers on loopback.
+# M1 is checked again built with -DNOPIDFD, which waits for children with the
+# signalfd fallback in childWatch.c, and built with -DSTRAGGLER, which stops the
+# first attempt at one index so that its backup must supply the sum.
+#
+# Usage: ./check.sh [check | stress | baseline]
+#
+# stress also sums STRESS_INTS ints and fails if the throughput in ints per
+# second falls below BASELINE_PERCENT percent of the rate recorded for that
+# method in BASELINE_FILE, failing as well if no rate was recorded. baseline
+# records both rates, which is done on purpose after a change that is meant to
+# alter throughput. Run from the directory holding the makefile. Each variant
+# is built in its own directory under RUN_DIR, so the objects and build flags
+# in the source tree are left alone.
+
+MODE=${1:-check}
+SRC_DIR=`pwd`
+BASELINE_FILE=$SRC_DIR/stress_baseline
+BASELINE_PERCENT=80
+STRESS_INTS=20000
+STRAGGLER_INDEX=20
+STRAGGLER_INTS=40
+WORKER_INTS=4000
+WORKER_PORT=`expr 20000 + $$ % 10000`
+
+SHMKEY=`sed -n 's/^#define SHMKEY \([0-9]*\).*/\1/p' shmkey.h`
+MAX_PROCESSES=`sed -n 's/^#define MAX_PROCESSES \([0-9]*\).*/\1/p' constants.h`
+MAX_RUNNING=`expr $MAX_PROCESSES - 2`
+
+RUN_DIR=`mktemp -d`
+trap 'rm -rf "$RUN_DIR"' EXIT
+FAILURES=0
+
+# Generates an input with randomTestGen and prints the expected sum. A fifth
+# argument of -p or -d writes a packed or delta-packed input.
+generate(){
+	"$RUN_DIR/randomTestGen" -o "$RUN_DIR/input" -s "$1" -n "$2" -l "$3" -u "$4" $5 \
+		| sed -n 's/^Random int sum: \(-*[0-9]*\)$/\1/p'
+}
+
+# Runs master on RUN_DIR/input and prints its sum, or nothing on failure.
+# master gets its own session, since cleanUp signals its whole process group.
+runMaster(){
+	(cd "$RUN_DIR" && setsid -w ./master input 2> /dev/null) \
+		| sed -n 's/^The sum is \(-*[0-9]*\)\..*$/\1/p'
+}
+
+# Compares master's sum with the expected sum, counting failures
+expectSum(){
+	got=`runMaster`
+	if [ "$got" != "$2" ]; then
+		echo "FAIL: $1: expected $2, master printed '$got'"
+		FAILURES=`expr $FAILURES + 1`
+	fi
+}
+
+# Checks n random ints in [min, max] with a seed derived from n, passing any
+# fourth argument on to randomTestGen
+checkRandom(){
+	expected=`generate $1 $1 $2 $3 $4`
+	expectSum "$METHOD_NAME n=$1 range [$2, $3] $4" "$expected"
+}
+
+# Runs the edge cases for the method that is currently built
+checkEdgeCases(){
+
+	# Tiny, odd, and power-of-two boundary sizes with negative values
+	for n in 1 2 3 4 5 6 7 9 15 16 17 31 33 63 64 65 127 129; do
+		checkRandom $n -1000 1000
+	done
+
+	# Sizes whose lg(n) isn't a power of two, giving uneven last groups
+	for n in 10 20 100 255 257 1000 1011 1012; do
+		checkRandom $n -1000 1000
+	done
+
+	# Sizes putting the number of children near multiples of MAX_RUNNING
+	for k in 1 2 3; do
+		for n in `expr $k \* $MAX_RUNNING - 1` `expr $k \* $MAX_RUNNING` \
+			`expr $k \* $MAX_RUNNING + 1` \
+			`expr 2 \* $k \* $MAX_RUNNING + 1` \
+			`expr 2 \* $k \* $MAX_RUNNING + 2` \
+			`expr 2 \* $k \* $MAX_RUNNING + 3`; do
+			checkRandom $n -1000 1000
+		done
+	done
+
+	# Only negative values, and values whose sum nearly fills an int
+	checkRandom 99 -255 -1
+	checkRandom 101 -20000000 20000000
+	checkRandom 300 6000000 7000000
+
+	# Packed inputs, including one spanning two blocks
+	checkRandom 1 -1000 1000 -p
+	checkRandom 37 -1000 1000 -p
+	checkRandom 101 -20000000 20000000 -d
+	checkRandom 4099 -1000 1000 -d
+	checkMalformed
+
+	# The checked-in fixture, summed independently
+	cp test "$RUN_DIR/input"
+	expectSum "$METHOD_NAME test" `awk '{ s += $1 } END { print s }' test`
+}
+
+# Checks that master rejects a packed input whose index entry starts at
+# 2^64 - 16 and spans 32 bytes, which wraps around if the two are added,
+# exiting through cleanUp and leaving no shared memory segment behind
+checkMalformed(){
+	generate 3 3 -1000 1000 -p > /dev/null
+	index=`od -An -tu8 -j24 -N8 "$RUN_DIR/input" | tr -d ' '`
+	printf '\360\377\377\377\377\377\377\377' | dd of="$RUN_DIR/input" \
+		bs=1 seek=$index conv=notrunc 2> /dev/null
+	printf '\040\000\000\000' | dd of="$RUN_DIR/input" bs=1 \
+		seek=`expr $index + 12` conv=notrunc 2> /dev/null
+
+	(cd "$RUN_DIR" && setsid -w ./master input > /dev/null 2>&1)
+	status=$?
+	if [ $status -ne 1 ] \
+		|| ipcs -m | grep -qi "^0x`printf %08x $SHMKEY` "; then
+		echo "FAIL: $METHOD_NAME: malformed index gave status $status" \
+			"or left shared memory behind"
+		FAILURES=`expr $FAILURES + 1`
+	fi
+
+	# packInts must reject it too, exiting alone with status 1
+	"$RUN_DIR/packInts" -x "$RUN_DIR/input" "$RUN_DIR/output" 2> /dev/null
+	status=$?
+	if [ $status -ne 1 ]; then
+		echo "FAIL: $METHOD_NAME: packInts -x of a malformed index" \
+			"gave status $status"
+		FAILURES=`expr $FAILURES + 1`
+	fi
+}
+
+# Starts two workers on loopback, each in its own session, and checks that
+# coordinator's sum of WORKER_INTS ints is right after the first worker's job
+# is killed mid-shard, that the shard was retried, and that the workers leave
+# no shared memory behind
+checkWorkers(){
+	expected=`generate 1 $WORKER_INTS -1000 1000`
+	cd "$RUN_DIR"
+
+	port1=$WORKER_PORT
+	port2=`expr $WORKER_PORT + 1`
+	setsid ./master -w $port1 2> worker1 &
+	worker1=$!
+	setsid ./master -w $port2 2> worker2 &
+	worker2=$!
+
+	# Waits for both to listen, then kills the first one's job once it
+	# has started summing
+	for i in `seq 50`; do
+		[ `cat worker1 worker2 | grep -c listening` -eq 2 ] && break
+		sleep 0.1
+	done
+	timeout 60 ./coordinator input 127.0.0.1:$port1 127.0.0.1:$port2 \
+		> out 2> err &
+	coordinator=$!
+	for i in `seq 100`; do
+		pgrep -P $worker1 -x master > /dev/null && break
+		sleep 0.05
+	done
+	sleep 0.2
+	pkill -KILL -P $worker1 -x master
+	wait $coordinator
+
+	kill -INT $worker1 $worker2
+	wait $worker1 $worker2 2> /dev/null
+	cd "$SRC_DIR"
+
+	got=`sed -n 's/^The sum is \(-*[0-9]*\)\..*$/\1/p' "$RUN_DIR/out"`
+	retried=`grep -c "failed shard" "$RUN_DIR/err"`
+	if [ "$got" != "$expected" ] || [ $retried -lt 1 ]; then
+		echo "FAIL: $METHOD_NAME workers: expected $expected after a" \
+			"retry, coordinator printed '$got' after $retried"
+		FAILURES=`expr $FAILURES + 1`
+	fi
+
+	for port in $port1 $port2; do
+		if ipcs -m | grep -qi "^0x`printf %08x \`expr $SHMKEY + $port\`` "
+		then
+			echo "FAIL: $METHOD_NAME workers: port $port left" \
+				"shared memory behind"
+			FAILURES=`expr $FAILURES + 1`
+		fi
+	done
+}
+
+# Sums STRAGGLER_INTS ints while the first attempt at STRAGGLER_INDEX is
+# stopped, checking that master finishes without it, that the sum is right,
+# and that exactly one attempt published. Output goes to files, since the
+# stopped attempt holds them open until it's killed.
+checkStraggler(){
+	expected=`generate 1 $STRAGGLER_INTS -1000 1000`
+	(cd "$RUN_DIR" && timeout 60 setsid -w ./master input > out 2> err)
+	pkill -KILL -f "^\./bin_adder $STRAGGLER_INDEX "
+
+	got=`sed -n 's/^The sum is \(-*[0-9]*\)\..*$/\1/p' "$RUN_DIR/out"`
+	backups=`grep -c "backup for index $STRAGGLER_INDEX " "$RUN_DIR/err"`
+	published=`grep -c "published index $STRAGGLER_INDEX\$" "$RUN_DIR/err"`
+
+	if [ "$got" != "$expected" ] || [ $backups -ne 1 ] \
+		|| [ $published -ne 1 ]; then
+		echo "FAIL: $METHOD_NAME: expected $expected with 1 backup and" \
+			"1 publisher, master printed '$got' with $backups" \
+			"and $published"
+		FAILURES=`expr $FAILURES + 1`
+	fi
+}
+
+# Sums STRESS_INTS ints and compares throughput with the recorded baseline
+checkThroughput(){
+	expected=`generate 1 $STRESS_INTS -1000 1000`
+
+	start=`date +%s%N`
+	expectSum "$METHOD_NAME n=$STRESS_INTS" "$expected"
+	end=`date +%s%N`
+
+	ms=`expr \( $end - $start \) / 1000000 + 1`
+	rate=`expr $STRESS_INTS \* 1000 / $ms`
+	baseline=`sed -n "s/^$METHOD_NAME \([0-9]*\)$/\1/p" "$BASELINE_FILE" \
+		2> /dev/null`
+	echo "$METHOD_NAME: $STRESS_INTS ints in $ms ms, $rate ints/s"
+
+	# Records the rate only when asked to
+	if [ "$MODE" = baseline ]; then
+		sed -i "/^$METHOD_NAME /d" "$BASELINE_FILE" 2> /dev/null
+		echo "$METHOD_NAME $rate" >> "$BASELINE_FILE"
+		echo "$METHOD_NAME: recorded baseline of $rate ints/s"
+
+	elif [ -z "$baseline" ]; then
+		echo "FAIL: $METHOD_NAME: no baseline in $BASELINE_FILE," \
+			"run ./check.sh baseline to record one"
+		FAILURES=`expr $FAILURES + 1`
+
+	elif [ $rate -lt `expr $baseline \* $BASELINE_PERCENT / 100` ]; then
+		echo "FAIL: $METHOD_NAME: $rate ints/s is below" \
+			"$BASELINE_PERCENT% of the $baseline ints/s baseline"
+		FAILURES=`expr $FAILURES + 1`
+	fi
+}
+
+case "$MODE" in
+	check|stress|baseline) ;;
+	*) echo "Usage: $0 [check | stress | baseline]"; exit 1 ;;
+esac
+
+for METHOD_NAME in M1 M2 M1-signalfd M1-straggler; do
+	[ $METHOD_NAME = M2 ] && METHOD=-DM2 || METHOD=
+	[ $METHOD_NAME = M1-signalfd ] && WATCH=-DNOPIDFD || WATCH=
+	[ $METHOD_NAME = M1-straggler ] && STRAGGLER=-DSTRAGGLER=$STRAGGLER_INDEX \
+		|| STRAGGLER=
+
+	# Builds without sleeping, since the sleeps would take hours
+	BUILD_DIR=$RUN_DIR/build-$METHOD_NAME
+	mkdir "$BUILD_DIR"
+	if ! make -C "$BUILD_DIR" -f "$SRC_DIR/makefile" SRC_DIR="$SRC_DIR" \
+		SLEEP=-DNOSLEEP METHOD=$METHOD WATCH=$WATCH \
+		STRAGGLER=$STRAGGLER all testgen > /dev/null; then
+		echo "FAIL: $METHOD_NAME: build failed"
+		exit 1
+	fi
+	cp "$BUILD_DIR/master" "$BUILD_DIR/bin_adder" \
+		"$BUILD_DIR/coordinator" "$BUILD_DIR/packInts" \
+		"$BUILD_DIR/randomTestGen" "$RUN_DIR"
+
+	if [ -n "$STRAGGLER" ]; then
+		echo "$METHOD_NAME: checking a backup for index $STRAGGLER_INDEX"
+		checkStraggler
+		continue
+	fi
+
+	echo "$METHOD_NAME: checking edge cases"
+	checkEdgeCases
+	if [ $METHOD_NAME = M1 ]; then
+		echo "$METHOD_NAME: checking coordinator with two workers"
+		checkWorkers
+	fi
+	[ "$MODE" = check ] || [ -n "$WATCH" ] || checkThroughput
+done
+
+if [ $FAILURES -gt 0 ]; then
+	echo "$FAILURES failed"
+	exit 1
+fi
+
+echo "All passed"
@@ -0,0 +1,149 @@
+// childWatch.c was created on 10/19/2026
+//
+// This file contains functions that wait for children with epoll. Each child
+// gets a pidfd, which becomes readable when it exits, so one epoll_wait
+// reports every finished child and only those children are reaped. Kernels
+// without pidfd_open (before 5.3), or builds with -DNOPIDFD, instead block
+// SIGCHLD and watch a signalfd, reaping with waitpid(-1) until none are left.
+
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/wait.h>
+
+#include "perrorExit.h"
+#include "constants.h"
+#include "childWatch.h"
+
+/* Prototypes */
+static int openPidfd(pid_t pid);
+static int reapAny(pid_t * pids, int maxPids);
+
+// Creates the epoll set, falling back to a signalfd if pidfds are unsupported
+void openChildWatch(ChildWatch * watch){
+	struct epoll_event event;	// Registers the signalfd
+	sigset_t sigchld;		// Contains SIGCHLD
+	int fd;
+
+	if ((watch->epollFd = epoll_create1(EPOLL_CLOEXEC)) == -1)
+		perrorExit("openChildWatch couldn't create epoll set");
+
+	// Uses pidfds if this kernel can open one for this process
+	watch->sigFd = -1;
+	if ((fd = openPidfd(getpid())) != -1){
+		close(fd);
+		return;
+	}
+
+	// Blocks SIGCHLD so it's only delivered through the signalfd
+	sigemptyset(&sigchld);
+	sigaddset(&sigchld, SIGCHLD);
+	if (sigprocmask(SIG_BLOCK, &sigchld, &watch->oldMask) == -1)
+		perrorExit("openChildWatch couldn't block SIGCHLD");
+
+	if ((watch->sigFd = signalfd(-1, &sigchld,
+		SFD_NONBLOCK | SFD_CLOEXEC)) == -1)
+		perrorExit("openChildWatch couldn't create signalfd");
+
+	event.events = EPOLLIN;
+	event.data.fd = watch->sigFd;
+	if (epoll_ctl(watch->epollFd, EPOLL_CTL_ADD, watch->sigFd, &event) == -1)
+		perrorExit("openChildWatch couldn't watch signalfd");
+}
+
+// Adds a child to the epoll set. The signalfd already covers every child.
+void watchChild(ChildWatch * watch, pid_t pid){
+	struct epoll_event event;
+	int fd;
+
+	if (watch->sigFd != -1) return;
+
+	if ((fd = openPidfd(pid)) == -1)
+		perrorExit("watchChild couldn't open pidfd");
+
+	// Keeps both the pid to reap and the pidfd to close with the event
+	event.events = EPOLLIN;
+	event.data.u64 = (uint64_t)pid << 32 | (uint32_t)fd;
+	if (epoll_ctl(watch->epollFd, EPOLL_CTL_ADD, fd, &event) == -1)
+		perrorExit("watchChild couldn't watch pidfd");
+}
+
+// Waits up to timeoutMs (-1 for no limit) for watched children to exit, reaps
+// up to maxPids of them, and stores their pids in pids. Returns the number
+// reaped, which is 0 after a timeout or a handled signal.
+int reapChildren(ChildWatch * watch, int timeoutMs, pid_t * pids, int maxPids){
+	struct epoll_event events[MAX_PROCESSES];
+	struct signalfd_siginfo info;	// Drained from the signalfd
+	int numEvents;
+	int numReaped;
+	int fd, i;
+
+	if (maxPids > MAX_PROCESSES) maxPids = MAX_PROCESSES;
+
+	// Reaps children left over from a wakeup that filled pids, whose
+	// SIGCHLD was already read
+	if (watch->sigFd != -1 && (numReaped = reapAny(pids, maxPids)) > 0)
+		return numReaped;
+
+	if ((numEvents = epoll_wait(watch->epollFd, events, maxPids,
+		timeoutMs)) == -1){
+		if (errno == EINTR) return 0;
+		perrorExit("reapChildren couldn't wait");
+	}
+
+	// Empties the signalfd, then reaps every child that has exited
+	if (watch->sigFd != -1){
+		if (numEvents == 0) return 0;
+		while (read(watch->sigFd, &info, sizeof(info)) == sizeof(info));
+		return reapAny(pids, maxPids);
+	}
+
+	// Reaps each child whose pidfd is readable, then removes the pidfd from
+	// the epoll set and closes it. Closing alone wouldn't remove it while
+	// a child that was forked but hasn't exec'd yet shares it, and its
+	// stale event would then name an fd since reused by another pidfd.
+	for (i = 0; i < numEvents; i++){
+		pids[i] = events[i].data.u64 >> 32;
+		fd = (uint32_t)events[i].data.u64;
+
+		while (waitpid(pids[i], NULL, 0) == -1 && errno == EINTR);
+		epoll_ctl(watch->epollFd, EPOLL_CTL_DEL, fd, NULL);
+		close(fd);
+	}
+
+	return numEvents;
+}
+
+// Closes the epoll set and restores the signal mask if SIGCHLD was blocked
+void closeChildWatch(ChildWatch * watch){
+	close(watch->epollFd);
+
+	if (watch->sigFd != -1){
+		close(watch->sigFd);
+		sigprocmask(SIG_SETMASK, &watch->oldMask, NULL);
+	}
+}
+
+// Returns a pidfd for pid, or -1 if pidfds are unsupported
+static int openPidfd(pid_t pid){
+#if defined(SYS_pidfd_open) && !defined(NOPIDFD)
+	return syscall(SYS_pidfd_open, pid, 0);
+#else
+	errno = ENOSYS;
+	return -1;
+#endif
+}
+
+// Reaps up to maxPids exited children without waiting, storing their pids
+static int reapAny(pid_t * pids, int maxPids){
+	int numReaped = 0;
+	pid_t pid;
+
+	while (numReaped < maxPids && (pid = waitpid(-1, NULL, WNOHANG)) > 0)
+		pids[numReaped++] = pid;
+
+	return numReaped;
+}
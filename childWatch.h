@@ -0,0 +1,25 @@
+// childWatch.h was created on 10/19/2026
+//
+// This file contains headers for the functions in childWatch.c, which let
+// master and bin_adder wait for any number of children in one epoll set and
+// reap every child that finished in a single wakeup.
+
+#ifndef CHILDWATCH_H
+#define CHILDWATCH_H
+
+#include <sys/types.h>
+#include <signal.h>
+
+/* An epoll set that becomes readable when a watched child exits */
+typedef struct {
+	int epollFd;		// Holds a pidfd per child, or sigFd
+	int sigFd;		// signalfd for SIGCHLD, or -1 if pidfds are used
+	sigset_t oldMask;	// Signal mask restored by closeChildWatch
+} ChildWatch;
+
+void openChildWatch(ChildWatch * watch);
+void watchChild(ChildWatch * watch, pid_t pid);
+int reapChildren(ChildWatch * watch, int timeoutMs, pid_t * pids, int maxPids);
+void closeChildWatch(ChildWatch * watch);
+
+#endif
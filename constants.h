@@ -8,6 +8,7 @@
 /* Used by master.c */
 #define MAX_SECONDS 100			// Max total execution time
 #define TIME_LOG_NAME "time_log"	// Name of file logging start & end
+#define DECODE_THREADS 4		// Threads decoding a packed input file
 
 /* Used by bin_adder.c */
 #define LOG_FILE_NAME "adder_log" 	// Name of the critical resource
@@ -15,6 +16,19 @@
 
 #define MAX_PROCESSES 20		// Max simultaneous processes
 #define MAX_RUNNING MAX_PROCESSES - 2	// Max children of bin_adder
+#define LOG_UPDATES 5			// Critical sections per bin_adder
+
+ // Decide when bin_adder launches a backup for a straggling child
+#define SPECULATE_PERCENTILE 90		// Percentile of recent group times
+#define SPECULATE_FACTOR 1.5		// Times the percentile to be a straggler
+#define SPECULATE_MIN_SAMPLES 5		// Groups timed before any backup
+#define SPECULATE_WINDOW 64		// Recent group times kept
+#ifndef STRAGGLER
+#define SPECULATE_MIN_MS 1000		// Groups faster than this aren't backed up
+#else
+#define SPECULATE_MIN_MS 100		// Lets check.sh's straggler be backed up
+#endif
+#define SPECULATE_TICK_MS 100		// Max ms between straggler checks
 
 
  // Defines sleep constants if option -DNOSLEEP not used
@@ -34,8 +48,18 @@
 #define POST_LOG_SLEEP 0
 #endif
 
+/* Used by coordinator.c and by master.c in worker mode */
+#define MAX_WORKERS 64			// Max workers given to coordinator
+#define MAX_SHARDS 1024			// Max shards the input is split into
+#define MAX_WORKER_FAILURES 2		// Failures before a worker is dropped
+#define WORKER_BACKLOG 16		// Pending connections per worker
+#define SHARD_CHUNK 65536		// Bytes per read/write of shard data
+#define SHARD_TIMEOUT_MS ((MAX_SECONDS + 10) * 1000) // Max wait for a reply
+
 /* Used by both master and bin_adder */
 #define BUFF_SZ 100			// The size of character buffers
 #define CHILD_PATH "./bin_adder"	// Path to child executable
+#define TRACE_LOG_NAME "trace_log"	// Binary trace written with -DTRACE
+#define TRACE_CAPACITY 256		// Trace records buffered per process
 
 #endif
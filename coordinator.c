@@ -0,0 +1,353 @@
+// coordinator.c was created on 10/19/2026
+//
+// This file contains a program which splits an input file of integers into
+// shards by byte range, sends each shard over TCP to a master running in
+// worker mode (master -w port), and adds the partial sums the workers return.
+// A shard whose worker fails, or doesn't reply within SHARD_TIMEOUT_MS, is
+// retried on the next idle worker, and a worker that fails
+// MAX_WORKER_FAILURES times is no longer used.
+//
+// Usage: coordinator [-s shards] inFile host:port [host:port ...]
+//
+// Each request is a line holding the shard's byte count followed by the
+// shard's bytes, and each reply is a line holding "sum milliseconds".
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/time.h>
+
+#include "perrorExit.h"
+#include "constants.h"
+#include "netIO.h"
+#include "packedInts.h"
+
+/* Shard and worker states */
+#define PENDING 0
+#define ASSIGNED 1
+#define DONE 2
+
+#define IDLE 0
+#define BUSY 1
+#define DEAD 2
+
+/* A contiguous range of whole lines of the input file */
+typedef struct {
+	long start;		// Offset of the first byte
+	long length;		// Number of bytes, excluding any appended \n
+	int appendNewline;	// 1 if the range doesn't end with \n
+	int state;		// PENDING, ASSIGNED, or DONE
+	int worker;		// Index of the worker that summed it
+	int sum;		// Partial sum returned by the worker
+	long ms;		// Milliseconds the worker spent on it
+} Shard;
+
+/* A master in worker mode */
+typedef struct {
+	char host[BUFF_SZ];	// Host name or address
+	int port;		// Port the worker listens on
+	int state;		// IDLE, BUSY, or DEAD
+	int failures;		// Failed shards so far
+	int fd;			// Connection while BUSY
+	int shard;		// Index of the shard while BUSY
+	struct timeval sent;	// When the shard was sent, while BUSY
+} Worker;
+
+/* Prototypes */
+static void parseWorker(Worker * worker, char * hostPort);
+static int splitFile(FILE * inFile, Shard * shards, int numShards);
+static void assignShards(FILE * inFile);
+static int sendShard(FILE * inFile, Shard * shard, int fd);
+static void collectResult(Worker * worker);
+static void failWorker(Worker * worker);
+static long elapsedMs(struct timeval * start);
+
+/* Static Global Variables */
+static Shard shards[MAX_SHARDS];	// Byte ranges of the input file
+static int numShards = 0;		// Number of shards in use
+static Worker workers[MAX_WORKERS];	// Workers named on the command line
+static int numWorkers = 0;		// Number of workers named
+static int shardsDone = 0;		// Number of DONE shards
+
+int main(int argc, char * argv[]){
+	FILE * inFile;			// The file with integers to split
+	struct pollfd fds[MAX_WORKERS];	// Connections of BUSY workers
+	int owners[MAX_WORKERS];	// Worker index for each pollfd
+	int numFds;			// Number of pollfds in use
+	int live;			// Number of workers not DEAD
+	long timeout;			// Ms until the first reply is overdue
+	long left;			// Ms until each reply is overdue
+	struct timeval start;		// Start of the whole job
+	long long sum = 0;		// Sum of all partial sums
+	PackedHeader header;		// Read only to reject packed input
+	int opt, i;
+
+	exeName = argv[0];
+	quitOnError = 1;	// Exits alone, since no children share its work
+
+	// Lets failed writes to a dead worker return an error instead
+	signal(SIGPIPE, SIG_IGN);
+
+	// Reads the number of shards, which defaults to one per worker
+	while ((opt = getopt(argc, argv, "s:")) != -1){
+		if (opt == 's') numShards = atoi(optarg);
+		else perrorQuit("Usage: [-s shards] inFile host:port ...");
+	}
+
+	if (argc - optind < 2)
+		perrorQuit("Usage: [-s shards] inFile host:port ...");
+	if (argc - optind - 1 > MAX_WORKERS)
+		perrorQuit("Too many workers");
+
+	// Reads the workers
+	for (i = optind + 1; i < argc; i++)
+		parseWorker(&workers[numWorkers++], argv[i]);
+
+	if (numShards <= 0) numShards = numWorkers;
+	if (numShards > MAX_SHARDS) numShards = MAX_SHARDS;
+
+	if ((inFile = fopen(argv[optind], "r")) == NULL)
+		perrorQuit("Couldn't open input file");
+
+	// Splits only text, since packed blocks don't end on newlines
+	if (readPackedHeader(inFile, &header) != 0){
+		errno = EINVAL;
+		perrorQuit("Input must be text; unpack it with packInts -x");
+	}
+
+	gettimeofday(&start, NULL);
+	shardsDone = splitFile(inFile, shards, numShards);
+
+	// Hands out shards and collects results until every shard is DONE
+	while (shardsDone < numShards){
+		assignShards(inFile);
+
+		// Builds the poll set from the BUSY workers and finds how long
+		// to wait before the first of their replies is overdue
+		numFds = live = 0;
+		timeout = SHARD_TIMEOUT_MS;
+		for (i = 0; i < numWorkers; i++){
+			if (workers[i].state != DEAD) live++;
+			if (workers[i].state != BUSY) continue;
+			fds[numFds].fd = workers[i].fd;
+			fds[numFds].events = POLLIN;
+			owners[numFds++] = i;
+
+			left = SHARD_TIMEOUT_MS - elapsedMs(&workers[i].sent);
+			if (left < timeout) timeout = left > 0 ? left : 0;
+		}
+
+		if (live == 0){
+			errno = EHOSTUNREACH;
+			perrorQuit("Every worker failed");
+		}
+
+		// Retries IDLE workers whose last attempt failed
+		if (numFds == 0) continue;
+
+		while (poll(fds, numFds, timeout) == -1)
+			if (errno != EINTR) perrorQuit("poll failed");
+
+		// Collects replies and fails workers whose reply is overdue
+		for (i = 0; i < numFds; i++){
+			if (fds[i].revents != 0)
+				collectResult(&workers[owners[i]]);
+			else if (elapsedMs(&workers[owners[i]].sent)
+				>= SHARD_TIMEOUT_MS)
+				failWorker(&workers[owners[i]]);
+		}
+	}
+
+	// Prints each partial result and combines them
+	for (i = 0; i < numShards; i++){
+		sum += shards[i].sum;
+
+		if (shards[i].length == 0) continue;
+		printf("Shard %d: bytes %ld-%ld on %s:%d, sum %d in %ld ms\n",
+			i, shards[i].start, shards[i].start + shards[i].length,
+			workers[shards[i].worker].host,
+			workers[shards[i].worker].port,
+			shards[i].sum, shards[i].ms
+		);
+	}
+
+	printf("The sum is %lld. Have a splendid day!\n", sum);
+	printf("Total time: %ld ms\n", elapsedMs(&start));
+
+	fclose(inFile);
+	return 0;
+}
+
+// Fills in a worker from a host:port argument or exits
+static void parseWorker(Worker * worker, char * hostPort){
+	char * colon = strrchr(hostPort, ':');
+
+	if (colon == NULL || colon == hostPort
+	    || colon - hostPort >= BUFF_SZ || atoi(colon + 1) <= 0){
+		errno = EINVAL;
+		perrorQuit("Workers must be given as host:port");
+	}
+
+	memcpy(worker->host, hostPort, colon - hostPort);
+	worker->host[colon - hostPort] = '\0';
+	worker->port = atoi(colon + 1);
+	worker->state = IDLE;
+	worker->failures = 0;
+	worker->fd = -1;
+}
+
+// Splits inFile into byte ranges ending on line boundaries, returning the
+// number of empty shards, which are marked DONE with a sum of zero
+static int splitFile(FILE * inFile, Shard * shards, int numShards){
+	long fileSize;		// Size of inFile in bytes
+	long boundary;		// End of the previous shard
+	long next;		// End of the current shard
+	int empty = 0;		// Number of empty shards
+	int ch, i;
+
+	fseek(inFile, 0, SEEK_END);
+	fileSize = ftell(inFile);
+
+	boundary = 0;
+	for (i = 0; i < numShards; i++){
+
+		// Moves each even split point past the end of its line
+		if (i == numShards - 1){
+			next = fileSize;
+		} else {
+			next = fileSize / numShards * (i + 1);
+			if (next <= boundary){
+				next = boundary;
+			} else {
+				fseek(inFile, next - 1, SEEK_SET);
+				while ((ch = fgetc(inFile)) != EOF && ch != '\n');
+				next = ftell(inFile);
+			}
+		}
+
+		shards[i].start = boundary;
+		shards[i].length = next - boundary;
+		shards[i].appendNewline = 0;
+		shards[i].state = PENDING;
+		shards[i].worker = 0;
+		shards[i].sum = 0;
+		shards[i].ms = 0;
+
+		if (shards[i].length == 0){
+			shards[i].state = DONE;
+			empty++;
+		}
+
+		boundary = next;
+	}
+
+	// master only stores an integer once its \n is read, so the shard holding
+	// the last byte gets one if the file doesn't end with it
+	if (fileSize > 0){
+		fseek(inFile, fileSize - 1, SEEK_SET);
+		for (i = numShards - 1; shards[i].length == 0; i--);
+		if (fgetc(inFile) != '\n') shards[i].appendNewline = 1;
+	}
+
+	return empty;
+}
+
+// Sends PENDING shards to IDLE workers, dropping workers that fail
+static void assignShards(FILE * inFile){
+	Worker * worker;
+	int shard = 0;	// Index of the next shard to consider
+	int i;
+
+	for (i = 0; i < numWorkers; i++){
+		worker = &workers[i];
+		if (worker->state != IDLE) continue;
+
+		// Finds the next PENDING shard
+		while (shard < numShards && shards[shard].state != PENDING)
+			shard++;
+		if (shard == numShards) return;
+
+		// Connects and sends, retrying the shard elsewhere on failure
+		worker->shard = shard;
+		if ((worker->fd = connectTo(worker->host, worker->port)) == -1
+		    || sendShard(inFile, &shards[shard], worker->fd) == -1){
+			failWorker(worker);
+			continue;
+		}
+
+		worker->state = BUSY;
+		gettimeofday(&worker->sent, NULL);
+		shards[shard].state = ASSIGNED;
+	}
+}
+
+// Writes the header and bytes of a shard to fd, returning -1 on failure
+static int sendShard(FILE * inFile, Shard * shard, int fd){
+	char chunk[SHARD_CHUNK];	// Bytes moved per write
+	long remaining;			// Bytes left to send
+	size_t got;			// Bytes read per fread
+	int length;			// Length of the header
+
+	length = sprintf(chunk, "%ld\n", shard->length + shard->appendNewline);
+	if (writeAll(fd, chunk, length) == -1) return -1;
+
+	fseek(inFile, shard->start, SEEK_SET);
+	for (remaining = shard->length; remaining > 0; remaining -= got){
+		got = fread(chunk, 1,
+			remaining < SHARD_CHUNK ? remaining : SHARD_CHUNK, inFile);
+		if (got == 0) perrorQuit("sendShard couldn't read input file");
+		if (writeAll(fd, chunk, got) == -1) return -1;
+	}
+
+	if (shard->appendNewline && writeAll(fd, "\n", 1) == -1) return -1;
+
+	return 0;
+}
+
+// Reads a BUSY worker's reply, marking its shard DONE or PENDING again
+static void collectResult(Worker * worker){
+	char reply[BUFF_SZ];		// "sum milliseconds"
+	Shard * shard = &shards[worker->shard];
+
+	if (readLine(worker->fd, reply, BUFF_SZ) == -1
+	    || sscanf(reply, "%d %ld", &shard->sum, &shard->ms) != 2){
+		failWorker(worker);
+		return;
+	}
+
+	close(worker->fd);
+	worker->fd = -1;
+	worker->state = IDLE;
+
+	shard->state = DONE;
+	shard->worker = worker - workers;
+	shardsDone++;
+}
+
+// Returns a failed worker's shard to PENDING and drops repeat offenders
+static void failWorker(Worker * worker){
+	fprintf(stderr, "%s: worker %s:%d failed shard %d\n",
+		exeName, worker->host, worker->port, worker->shard);
+
+	if (worker->fd != -1) close(worker->fd);
+	worker->fd = -1;
+
+	shards[worker->shard].state = PENDING;
+	shards[worker->shard].sum = 0;
+
+	worker->failures++;
+	worker->state = worker->failures >= MAX_WORKER_FAILURES ? DEAD : IDLE;
+}
+
+// Returns the milliseconds since start
+static long elapsedMs(struct timeval * start){
+	struct timeval now;
+
+	gettimeofday(&now, NULL);
+	return (now.tv_sec - start->tv_sec) * 1000
+		+ (now.tv_usec - start->tv_usec) / 1000;
+}
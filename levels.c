@@ -0,0 +1,34 @@
+// levels.c was created on 10/19/2026
+//
+// This file contains the arithmetic shared by master, bin_adder, and simulate
+// for dividing each level of the summation into groups, so the simulator
+// always models the same levels the real programs run.
+
+#include <math.h>
+
+// Returns the number of groups a bin_adder called with index -1 or -2 adds
+// and sets groupSize to the number of ints per group
+int levelGroups(int index, int size, int * groupSize){
+	int numGroups = 0; // The number of groups of ints to add
+
+	// Computes values for method 1
+	if (index == -1) {
+		numGroups = (int)ceil(size/2.0);
+		*groupSize = 2;
+
+	// Computes values for method 2
+	} else if (index == -2) {
+		*groupSize = (int)ceil(log((double)size)/log(2.0));
+		numGroups = (size + *groupSize - 1) / *groupSize;
+	}
+
+	return numGroups;
+}
+
+// Returns the number of ints left after a level launched with index, which
+// is the number of groups, since each group leaves one sum
+int nextLevelSize(int index, int size){
+	int groupSize;
+
+	return levelGroups(index, size, &groupSize);
+}
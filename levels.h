@@ -0,0 +1,12 @@
+// levels.h was created on 10/19/2026
+//
+// This file contains headers for the functions in levels.c, which decide how
+// many ints each level of the summation has and how they're grouped.
+
+#ifndef LEVELS_H
+#define LEVELS_H
+
+int levelGroups(int index, int size, int * groupSize);
+int nextLevelSize(int index, int size);
+
+#endif
@@ -3,7 +3,12 @@
 // This file contains a program which reads integers from a file into a shared
 // memory array, divides them into groups, creates children that sum each group
 // and append comments to a log file, and records the start and end time of
-// computation.
+// computation. The file may be text, one int per line, or packed as described
+// in packedInts.h, in which case its blocks are decoded in parallel.
+//
+// Called with -w port instead of a file name, master becomes a worker for
+// coordinator: it accepts shards over TCP, sums each one as above in a forked
+// job, and replies with the sum and the elapsed milliseconds.
 
 #include <ctype.h>
 #include <stdio.h>
@@ -20,6 +25,8 @@
 #include <sys/ipc.h>
 #include <sys/shm.h>
 #include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/socket.h>
 #include <errno.h>
 #include <math.h>
 
@@ -27,6 +34,12 @@
 #include "sharedMemory.h"
 #include "shmkey.h"
 #include "constants.h"
+#include "netIO.h"
+#include "trace.h"
+#include "levels.h"
+#include "packedInts.h"
+#include "tasks.h"
+#include "childWatch.h"
 
 /* Preprocessor directives determining summation method used */
 #ifdef M2
@@ -42,28 +55,39 @@ static int numberOfIntegers(FILE * inFile);
 static void copyIntegersFromFile(int * intArray, int numInts);
 static void launchChildren(int * intArray, int numInts, int shmSize);
 static pid_t createChild(int index, int numInts, int shmSize);
+static void awaitChild(ChildWatch * watch, pid_t pid);
 static void cleanUp();
 static void initializeSemaphore(pthread_mutex_t *);
+static int sumIntegers();
+static void serveShards(int port);
+static void sumShard(int connFd);
+static void copyShard(int connFd, FILE * shardFile, long long shardBytes);
 
 /* Static Global Variables */
 static char * shm = NULL;	 	// Pointer to the shared memory region
 static FILE * inFile = NULL;	 	// The file with integers to read
 static FILE * timeLog = NULL;		// Logs start and end times
+static key_t shmKey = SHMKEY;		// Key of the shared memory region
 
 int main(int argc, char * argv[]){
-	unsigned int numInts;	 // The number of integers to read from input
-	int * intArray;		 // Pointer to the first int in the shared array
-	int shmSz;		 // The size of the shared memory region in bytes
+	int sum;		 // The sum of the integers in the input file
 	
 	FILE * timeLog;
 
-	pthread_mutex_t * lgSem;	// Semaphore protecting main logFile
-	pthread_mutex_t * semLgSem;	// Sem protecting sem activity log file
-
-	alarm(MAX_SECONDS);	 // Limits total execution time to MAX_SECONDS
 	exeName = argv[0];	 // Assigns executable name for perrorExit
 	assignSignalHandlers();	 // Determines response to ctrl + C & alarm
 
+	// Serves shards to a coordinator if called with -w port
+	if (argc > 1 && strcmp(argv[1], "-w") == 0){
+		if (argc < 3) perrorExit("Please specify a port after -w");
+		serveShards(atoi(argv[2]));
+		return 0;
+	}
+
+	alarm(MAX_SECONDS);	 // Limits total execution time to MAX_SECONDS
+	traceNewLog();		 // Drops records left by an earlier run
+	traceInit(TRACE_MASTER_INDEX);
+
 	// Prints start time
 	timeLog = fopen(TIME_LOG_NAME, "w");
 	time_t current = time(NULL);
@@ -74,11 +98,49 @@ int main(int argc, char * argv[]){
 	if ((inFile = fopen(argv[1], "r")) == NULL)
 		perrorExit("Couldn't open input file");
 
+	// Sums the integers in inFile using bin_adder children
+	sum = sumIntegers();
+
+	// Prints result
+	printf("The sum is %d. Have a splendid day!\n", sum);
+
+	// Prints end time
+	current = time(NULL);
+	fprintf(timeLog, "End time: %s", ctime(&current));
+	fclose(timeLog);
+	
+	// Ignores interrupts, kills child processes, closes files, removes shm
+	cleanUp();
+
+	return 0;
+}
+
+// Copies inFile into shared memory, launches children, and returns the sum
+static int sumIntegers(){
+	unsigned int numInts;	 // The number of integers to read from input
+	int * intArray;		 // Pointer to the first int in the shared array
+	int shmSz;		 // The size of the shared memory region in bytes
+
+	pthread_mutex_t * lgSem;	// Semaphore protecting main logFile
+	pthread_mutex_t * semLgSem;	// Sem protecting sem activity log file
+
+	PackedHeader header;	 // Header of a packed input file
+	int packed;		 // 1 if inFile is packed, 0 if it's text
+
 	// Counts the number of integers in the input file
-	numInts = numberOfIntegers(inFile);
+	if ((packed = readPackedHeader(inFile, &header)) == -1){
+		errno = EINVAL;
+		perrorExit("Malformed packed input file");
+	}
+	numInts = packed ? header.numInts : numberOfIntegers(inFile);
 
-	// Allocates shared memory for log file and integers
-	shmSz = sizeof(FILE*) + sizeof(pthread_mutex_t) + numInts * sizeof(int);
+	// Allocates shared memory for both semaphores, the integers, and the
+	// task slots bin_adder uses to back up stragglers
+	if ((shmSz = sharedSize(numInts)) == -1){
+		errno = EFBIG;
+		perrorExit("Too many integers for shared memory");
+	}
+	setSharedMemoryKey(shmKey);
 	shm = sharedMemory(shmSz, IPC_CREAT);
 
 	// Sets addresses of a lgSemaphore and the integer array
@@ -91,23 +153,125 @@ int main(int argc, char * argv[]){
 	initializeSemaphore(semLgSem);
 
 	// Copies ints from file into shared integer array
-	copyIntegersFromFile(intArray, numInts);
+	if (packed)
+		decodePackedInts(inFile, &header, intArray, DECODE_THREADS);
+	else
+		copyIntegersFromFile(intArray, numInts);
 	
 	// Launches children
 	launchChildren(intArray, numInts, shmSz);
 
-	// Prints result
-	printf("The sum is %d. Have a splendid day!\n", intArray[0]);
+	return intArray[0];
+}
+
+// Accepts shards from coordinator forever, summing each in a forked job
+static void serveShards(int port){
+	int listenFd;	// Socket accepting coordinator connections
+	int connFd;	// Connection carrying one shard
+	pid_t pid;	// Pid of the job summing the shard
+
+	// Keeps cleanUp's group-wide signal from reaching whatever started the
+	// worker. It fails harmlessly in a session leader, which leads its group.
+	setpgid(0, 0);
+
+	// Binds before touching shared state, so a second worker on a port in
+	// use fails without disturbing the first
+	listenFd = listenOn(port);
+
+	// Gives each worker on a host its own shared memory region, removing
+	// any left by a previous worker on this port
+	shmKey = SHMKEY + port;
+	setSharedMemoryKey(shmKey);
+	removeSegmentWithKey();
+
+	// Keeps only this worker's jobs in the trace log
+	traceNewLog();
+
+	fprintf(stderr, "%s: worker listening on port %d\n", exeName, port);
+
+	while (1){
+		while ((connFd = accept(listenFd, NULL, NULL)) == -1
+			&& errno == EINTR);
+		if (connFd == -1) perrorExit("serveShards failed to accept");
+
+		if ((pid = fork()) == -1) perrorExit("serveShards failed to fork");
+
+		// Sums the shard in the child, which never returns
+		if (pid == 0){
+			close(listenFd);
+			sumShard(connFd);
+		}
+
+		// Handles one shard at a time, since each uses all MAX_RUNNING
+		close(connFd);
+		while (waitpid(pid, NULL, 0) == -1 && errno == EINTR);
+
+		// Kills any bin_adders orphaned by a job that died, since they
+		// share the job's process group, and removes the job's segment
+		// so they can't touch the next shard's ints or mutexes
+		kill(-pid, SIGKILL);
+		removeSegmentWithKey();
+	}
+}
+
+// Reads a shard from connFd, sums it, and replies with the sum and time
+static void sumShard(int connFd){
+	char buff[BUFF_SZ];		// Holds the header and the reply
+	struct timeval start, end;	// Times the job
+	long elapsedMs;			// Milliseconds spent on the shard
+	int sum;			// The sum of the shard
+
+	// Lets cleanUp kill this job's bin_adders without killing the worker
+	setpgid(0, 0);
+	signal(SIGPIPE, SIG_IGN);
+	alarm(MAX_SECONDS);
+	traceInit(TRACE_MASTER_INDEX);
+	gettimeofday(&start, NULL);
+
+	// Keeps bin_adders from inheriting the connection, which would hold it
+	// open for coordinator after this job died
+	if (fcntl(connFd, F_SETFD, FD_CLOEXEC) == -1)
+		perrorExit("sumShard couldn't set close-on-exec");
+
+	// Reads the byte count header, then copies the shard to a temporary file
+	if (readLine(connFd, buff, BUFF_SZ) == -1)
+		perrorExit("sumShard couldn't read shard header");
+	if ((inFile = tmpfile()) == NULL
+	    || fcntl(fileno(inFile), F_SETFD, FD_CLOEXEC) == -1)
+		perrorExit("sumShard couldn't create temporary file");
+	copyShard(connFd, inFile, atoll(buff));
+	rewind(inFile);
+
+	// Sums the shard exactly as master sums a file
+	sum = sumIntegers();
+
+	// Replies to coordinator, which treats a missing reply as a failure
+	gettimeofday(&end, NULL);
+	elapsedMs = (end.tv_sec - start.tv_sec) * 1000
+		+ (end.tv_usec - start.tv_usec) / 1000;
+	sprintf(buff, "%d %ld\n", sum, elapsedMs);
+	writeAll(connFd, buff, strlen(buff));
+	close(connFd);
 
-	// Prints end time
-	current = time(NULL);
-	fprintf(timeLog, "End time: %s", ctime(&current));
-	fclose(timeLog);
-	
-	// Ignores interrupts, kills child processes, closes files, removes shm
 	cleanUp();
+	exit(0);
+}
 
-	return 0;
+// Copies shardBytes bytes from connFd to shardFile or exits
+static void copyShard(int connFd, FILE * shardFile, long long shardBytes){
+	char chunk[SHARD_CHUNK];	// Bytes moved per read
+	ssize_t got;			// Bytes received per read
+
+	while (shardBytes > 0){
+		got = readAll(connFd, chunk,
+			shardBytes < SHARD_CHUNK ? shardBytes : SHARD_CHUNK);
+		if (got <= 0) perrorExit("copyShard lost the connection");
+
+		if (fwrite(chunk, 1, got, shardFile) != got)
+			perrorExit("copyShard couldn't write temporary file");
+
+		shardBytes -= got;
+	}
 }
 
 // Determines the processes response to ctrl + c or alarm
@@ -159,9 +323,11 @@ static void cleanUp(){
 	if (inFile != NULL) fclose(inFile);
 	if (timeLog != NULL) fclose(timeLog);
 
-	// Detatches from and removes shared memory
-	detach(shm);
-	removeSegment();
+	// Detatches from and removes shared memory if it was created
+	if (shm != NULL){
+		detach(shm);
+		removeSegment();
+	}
 }
 
 // Counts the integers and validates the file format or exits
@@ -280,26 +446,41 @@ static void initializeSemaphore(pthread_mutex_t * mutex){
 static void launchChildren(int * intArray, int numInts, int shmSize){
 	int intsToAdd;	// The number of integers for the child to add
 	pid_t pid;	// Pid of each child process launch children creates
+	ChildWatch watch; // Reports when each level's bin_adder finishes
 	
 	intsToAdd = numInts;
+	openChildWatch(&watch);
 
-	// Applies one iteration of method 2 if selected
-	if (METHOD == 2){
+	// Applies one iteration of method 2 if selected and lg(n) is defined
+	if (METHOD == 2 && intsToAdd > 1){
+		traceEvent(TRACE_LEVEL_BEGIN, intsToAdd, TRACE_NO_LOCK);
 		pid = createChild(-2, intsToAdd, shmSize);
-		waitpid(pid, NULL, 0);
-		intsToAdd = \
-			(int)ceil(intsToAdd/(log((double)intsToAdd)/log(2.0)));
+		awaitChild(&watch, pid);
+		traceEvent(TRACE_LEVEL_END, intsToAdd, TRACE_NO_LOCK);
+		intsToAdd = nextLevelSize(-2, intsToAdd);
 
 	}
 
 	// Applies method 1 until a result is obtained
 	while(intsToAdd > 1){
+		traceEvent(TRACE_LEVEL_BEGIN, intsToAdd, TRACE_NO_LOCK);
 		pid = createChild(-1, intsToAdd, shmSize);
-		waitpid(pid, NULL, 0);
+		awaitChild(&watch, pid);
+		traceEvent(TRACE_LEVEL_END, intsToAdd, TRACE_NO_LOCK);
 
-		intsToAdd = (int)ceil(intsToAdd/2.0);
+		intsToAdd = nextLevelSize(-1, intsToAdd);
 	}
 
+	closeChildWatch(&watch);
+}
+
+// Waits until the bin_adder pid has been reaped. Each level uses the results
+// of the one before it, so there is nothing for master to do meanwhile.
+static void awaitChild(ChildWatch * watch, pid_t pid){
+	pid_t reaped = 0;
+
+	watchChild(watch, pid);
+	while (reaped != pid) reapChildren(watch, -1, &reaped, 1);
 }
 
 // Forks and execs a single bin_adder process
@@ -319,7 +500,10 @@ static pid_t createChild(int index, int numInts, int shmSize){
 		char shmSz[BUFF_SZ];
 		sprintf(shmSz, "%d", shmSize);
 
-		execl(CHILD_PATH, CHILD_PATH, indx, nInts, shmSz, NULL);
+		char key[BUFF_SZ];
+		sprintf(key, "%d", (int)shmKey);
+
+		execl(CHILD_PATH, CHILD_PATH, indx, nInts, shmSz, key, NULL);
 		perrorExit("Failed to exec!");
 
 	}
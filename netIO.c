@@ -0,0 +1,122 @@
+// netIO.c was created on 10/19/2026
+//
+// This file contains functions for listening on and connecting to TCP ports
+// and for reading and writing whole buffers and lines on socket descriptors.
+// Only listenOn exits on failure, since coordinator must survive dead workers.
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#include "perrorExit.h"
+#include "constants.h"
+
+// Returns a socket listening on port on all interfaces or exits on failure
+int listenOn(int port){
+	struct sockaddr_in addr;	// The address to bind
+	int fd;				// The listening socket
+	int reuse = 1;			// Allows quick restarts on the same port
+
+	if ((fd = socket(AF_INET, SOCK_STREAM, 0)) == -1)
+		perrorExit("listenOn couldn't create socket");
+
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	addr.sin_port = htons(port);
+
+	if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) == -1)
+		perrorExit("listenOn couldn't bind");
+
+	if (listen(fd, WORKER_BACKLOG) == -1)
+		perrorExit("listenOn couldn't listen");
+
+	return fd;
+}
+
+// Returns a socket connected to host:port, or -1 on failure
+int connectTo(char * host, int port){
+	struct addrinfo hints;		// Restricts lookup to TCP
+	struct addrinfo * results;	// Addresses found for host
+	struct addrinfo * ai;		// Each address tried
+	char portBuff[BUFF_SZ];		// Port as a service string
+	int fd = -1;			// The connected socket
+
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	sprintf(portBuff, "%d", port);
+
+	if (getaddrinfo(host, portBuff, &hints, &results) != 0) return -1;
+
+	// Tries each address until one connects
+	for (ai = results; ai != NULL; ai = ai->ai_next){
+		if ((fd = socket(ai->ai_family, ai->ai_socktype,
+			ai->ai_protocol)) == -1)
+			continue;
+
+		if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) break;
+
+		close(fd);
+		fd = -1;
+	}
+
+	freeaddrinfo(results);
+	return fd;
+}
+
+// Reads up to a \n into buff, null terminated, returning its length or -1
+int readLine(int fd, char * buff, int buffSize){
+	int length = 0;	// Number of chars stored in buff
+	ssize_t got;	// Return value of each read
+	char ch;	// Each char read
+
+	// Reads one char at a time so no bytes after the line are consumed
+	while (length + 1 < buffSize){
+		while ((got = read(fd, &ch, 1)) == -1 && errno == EINTR);
+		if (got <= 0) return -1;
+		if (ch == '\n') break;
+		buff[length++] = ch;
+	}
+
+	buff[length] = '\0';
+	return length;
+}
+
+// Reads exactly count bytes unless EOF or an error occurs first
+ssize_t readAll(int fd, void * buff, size_t count){
+	size_t total = 0;	// Bytes read so far
+	ssize_t got;		// Return value of each read
+
+	while (total < count){
+		got = read(fd, (char *)buff + total, count - total);
+		if (got == -1 && errno == EINTR) continue;
+		if (got == -1) return -1;
+		if (got == 0) break;
+		total += got;
+	}
+
+	return total;
+}
+
+// Writes exactly count bytes, returning count or -1 on failure
+ssize_t writeAll(int fd, void * buff, size_t count){
+	size_t total = 0;	// Bytes written so far
+	ssize_t put;		// Return value of each write
+
+	while (total < count){
+		put = write(fd, (char *)buff + total, count - total);
+		if (put == -1 && errno == EINTR) continue;
+		if (put == -1) return -1;
+		total += put;
+	}
+
+	return total;
+}
@@ -0,0 +1,17 @@
+// netIO.h was created on 10/19/2026
+//
+// This file contains headers for the TCP helper functions used by master in
+// worker mode and by coordinator, which are defined in netIO.c
+
+#ifndef NETIO_H
+#define NETIO_H
+
+#include <sys/types.h>
+
+int listenOn(int port);
+int connectTo(char * host, int port);
+int readLine(int fd, char * buff, int buffSize);
+ssize_t readAll(int fd, void * buff, size_t count);
+ssize_t writeAll(int fd, void * buff, size_t count);
+
+#endif
@@ -0,0 +1,107 @@
+// packInts.c was created on 10/19/2026
+//
+// This file contains a program which converts a text file of integers, one per
+// line, to the packed format described in packedInts.h, or back again.
+//
+// Usage: packInts [-d] [-b blockSize] textFile packedFile
+//	  packInts -x packedFile textFile
+//
+// -d delta-encodes the ints, which shrinks files of sorted or slowly varying
+// values, and -b sets the ints per block, which bounds decoding parallelism.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "perrorExit.h"
+#include "constants.h"
+#include "packedInts.h"
+
+/* Prototypes */
+static void pack(FILE * inFile, FILE * outFile, int flags, int blockSize);
+static void unpack(FILE * inFile, FILE * outFile);
+
+int main(int argc, char * argv[]){
+	FILE * inFile;		// The file to convert
+	FILE * outFile;		// The converted file
+	int flags = 0;		// PACKED_DELTA if -d is given
+	int blockSize = PACKED_BLOCK_SIZE;
+	int extract = 0;	// 1 to convert packed to text
+	int opt;
+
+	exeName = argv[0];
+	quitOnError = 1;	// Exits alone, including from decodePackedInts
+
+	while ((opt = getopt(argc, argv, "db:x")) != -1){
+		switch (opt){
+		case 'd': flags |= PACKED_DELTA; break;
+		case 'b': blockSize = atoi(optarg); break;
+		case 'x': extract = 1; break;
+		default:
+			errno = EINVAL;
+			perrorQuit("Unknown option, see packInts.c for usage");
+		}
+	}
+
+	if (argc - optind != 2 || blockSize < 1){
+		errno = EINVAL;
+		perrorQuit("Please specify an input and an output file");
+	}
+
+	if ((inFile = fopen(argv[optind], "r")) == NULL)
+		perrorQuit("Couldn't open input file");
+	if ((outFile = fopen(argv[optind + 1], "w")) == NULL)
+		perrorQuit("Couldn't open output file");
+
+	if (extract) unpack(inFile, outFile);
+	else pack(inFile, outFile, flags, blockSize);
+
+	fclose(inFile);
+	if (fclose(outFile) == EOF) perrorQuit("Couldn't close output file");
+
+	return 0;
+}
+
+// Writes each int in a text file to a packed file
+static void pack(FILE * inFile, FILE * outFile, int flags, int blockSize){
+	PackedWriter * writer;
+	int value;
+	int matched;
+
+	if ((writer = packedOpen(outFile, flags, blockSize)) == NULL)
+		perrorQuit("Couldn't start packed file");
+
+	while ((matched = fscanf(inFile, "%d", &value)) == 1)
+		if (packedWrite(writer, value) == -1)
+			perrorQuit("Couldn't write packed file");
+
+	if (matched != EOF || ferror(inFile)){
+		errno = EINVAL;
+		perrorQuit("Input file contains a non-int");
+	}
+
+	if (packedClose(writer) == -1) perrorQuit("Couldn't finish packed file");
+}
+
+// Writes each int in a packed file to a text file, one per line
+static void unpack(FILE * inFile, FILE * outFile){
+	PackedHeader header;
+	int * intArray;
+	uint64_t i;
+
+	if (readPackedHeader(inFile, &header) != 1){
+		errno = EINVAL;
+		perrorQuit("Input file isn't a valid packed file");
+	}
+
+	if ((intArray = malloc((header.numInts + 1) * sizeof(int))) == NULL)
+		perrorQuit("Couldn't allocate memory");
+
+	decodePackedInts(inFile, &header, intArray, DECODE_THREADS);
+
+	for (i = 0; i < header.numInts; i++)
+		fprintf(outFile, "%d\n", intArray[i]);
+
+	free(intArray);
+}
@@ -0,0 +1,341 @@
+// packedInts.c was created on 10/19/2026
+//
+// This file contains functions that write integers in the packed format
+// described in packedInts.h and decode packed files in parallel. The writer
+// keeps only one block and the index in memory. The decoder maps the file and
+// has each thread decode a contiguous run of blocks straight into intArray,
+// which master places in shared memory.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "perrorExit.h"
+#include "packedInts.h"
+
+/* Blocks decoded by one thread */
+typedef struct {
+	unsigned char * file;	// The mapped file
+	PackedHeader * header;	// Its header
+	int * intArray;		// Destination of the first int of the file
+	uint64_t * positions;	// Index in intArray of each block's first int
+	uint32_t firstBlock;	// First block to decode
+	uint32_t endBlock;	// Block after the last one to decode
+	int failed;		// Set to 1 if a block is malformed
+} DecodeJob;
+
+/* Prototypes */
+static void * decodeBlocks(void * arg);
+static int decodeBlock(unsigned char * src, uint32_t bytes, uint32_t count,
+	int * dst, int delta);
+static int flushBlock(PackedWriter * writer);
+static void put32(unsigned char * buff, uint32_t value);
+static void put64(unsigned char * buff, uint64_t value);
+static uint32_t get32(unsigned char * buff);
+static uint64_t get64(unsigned char * buff);
+
+// Reads the header, returning 1 if inFile is packed, 0 if it isn't, and -1 if
+// it starts with PACKED_MAGIC but the header is malformed. Leaves inFile
+// rewound.
+int readPackedHeader(FILE * inFile, PackedHeader * header){
+	unsigned char buff[PACKED_HEADER_SIZE];
+	struct stat status;
+	size_t got;
+
+	rewind(inFile);
+	got = fread(buff, 1, PACKED_HEADER_SIZE, inFile);
+	rewind(inFile);
+
+	if (got < 4 || memcmp(buff, PACKED_MAGIC, 4) != 0) return 0;
+	if (got < PACKED_HEADER_SIZE || fstat(fileno(inFile), &status) == -1)
+		return -1;
+
+	header->flags = get32(buff + 4);
+	header->numInts = get64(buff + 8);
+	header->numBlocks = get32(buff + 16);
+	header->blockSize = get32(buff + 20);
+	header->indexOffset = get64(buff + 24);
+
+	// The index must fit between the blocks and the end of the file
+	if (header->indexOffset < PACKED_HEADER_SIZE
+	    || header->indexOffset > (uint64_t)status.st_size
+	    || ((uint64_t)status.st_size - header->indexOffset)
+		/ PACKED_ENTRY_SIZE < header->numBlocks
+	    || header->numInts > 0x7fffffff)
+		return -1;
+
+	return 1;
+}
+
+// Decodes every block of a packed file into intArray using numThreads threads
+void decodePackedInts(FILE * inFile, PackedHeader * header, int * intArray,
+	int numThreads){
+	unsigned char * file;		// The mapped file
+	unsigned char * entry;		// Each index entry
+	uint64_t * positions;		// First int of each block
+	uint64_t total = 0;		// Ints in the blocks so far
+	size_t fileSize;		// Bytes mapped
+	pthread_t threads[numThreads];
+	DecodeJob jobs[numThreads];
+	uint32_t block;
+	int i;
+
+	// A file without blocks must not claim any ints
+	if (header->numBlocks == 0){
+		if (header->numInts == 0) return;
+		errno = EINVAL;
+		perrorExit("decodePackedInts found the wrong number of ints");
+	}
+
+	// Maps the whole file rather than copying it through stdio
+	fileSize = header->indexOffset
+		+ (size_t)header->numBlocks * PACKED_ENTRY_SIZE;
+	file = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fileno(inFile), 0);
+	if (file == MAP_FAILED) perrorExit("decodePackedInts couldn't map file");
+
+	// Finds where each block's ints go and checks the index
+	if ((positions = malloc(header->numBlocks * sizeof(uint64_t))) == NULL)
+		perrorExit("decodePackedInts couldn't allocate memory");
+
+	for (block = 0; block < header->numBlocks; block++){
+		entry = file + header->indexOffset + block * PACKED_ENTRY_SIZE;
+		positions[block] = total;
+		total += get32(entry + 8);
+
+		// Compares without adding, which could wrap past indexOffset
+		if (get32(entry + 8) > header->blockSize
+		    || get64(entry) < PACKED_HEADER_SIZE
+		    || get64(entry) > header->indexOffset
+		    || get32(entry + 12) > header->indexOffset - get64(entry)){
+			errno = EINVAL;
+			perrorExit("decodePackedInts found a bad index entry");
+		}
+	}
+
+	if (total != header->numInts){
+		errno = EINVAL;
+		perrorExit("decodePackedInts found the wrong number of ints");
+	}
+
+	// Gives each thread an equal share of the blocks
+	if (numThreads > header->numBlocks) numThreads = header->numBlocks;
+	for (i = 0; i < numThreads; i++){
+		jobs[i].file = file;
+		jobs[i].header = header;
+		jobs[i].intArray = intArray;
+		jobs[i].positions = positions;
+		jobs[i].firstBlock = (uint64_t)header->numBlocks * i / numThreads;
+		jobs[i].endBlock =
+			(uint64_t)header->numBlocks * (i + 1) / numThreads;
+		jobs[i].failed = 0;
+
+		if ((errno = pthread_create(&threads[i], NULL, decodeBlocks,
+			&jobs[i])) != 0)
+			perrorExit("decodePackedInts couldn't create thread");
+	}
+
+	for (i = 0; i < numThreads; i++){
+		pthread_join(threads[i], NULL);
+		if (jobs[i].failed){
+			errno = EINVAL;
+			perrorExit("decodePackedInts found a malformed block");
+		}
+	}
+
+	free(positions);
+	munmap(file, fileSize);
+}
+
+// Thread body decoding the blocks of one DecodeJob
+static void * decodeBlocks(void * arg){
+	DecodeJob * job = arg;
+	unsigned char * entry;
+	uint32_t block;
+
+	for (block = job->firstBlock; block < job->endBlock; block++){
+		entry = job->file + job->header->indexOffset
+			+ block * PACKED_ENTRY_SIZE;
+
+		if (decodeBlock(job->file + get64(entry), get32(entry + 12),
+			get32(entry + 8), job->intArray + job->positions[block],
+			job->header->flags & PACKED_DELTA) == -1){
+			job->failed = 1;
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+// Decodes count zigzag varints from exactly bytes bytes, returning -1 if the
+// block is malformed
+static int decodeBlock(unsigned char * src, uint32_t bytes, uint32_t count,
+	int * dst, int delta){
+	unsigned char * end = src + bytes;
+	uint32_t previous = 0;	// Last int decoded, for delta decoding
+	uint32_t value;		// Each varint
+	uint32_t i;
+	int shift;
+
+	for (i = 0; i < count; i++){
+
+		// Takes the common one-byte case without a loop
+		if (src < end && *src < 0x80){
+			value = *src++;
+		} else {
+			value = 0;
+			for (shift = 0; ; shift += 7){
+				if (src == end || shift == 7 * PACKED_MAX_VARINT)
+					return -1;
+				value |= (uint32_t)(*src & 0x7f) << shift;
+				if (*src++ < 0x80) break;
+			}
+		}
+
+		// Undoes zigzag encoding, then delta encoding if it was used
+		value = (value >> 1) ^ -(value & 1);
+		if (delta) value = previous += value;
+		dst[i] = (int)value;
+	}
+
+	return src == end ? 0 : -1;
+}
+
+// Starts a packed file, returning NULL on failure
+PackedWriter * packedOpen(FILE * outFile, int flags, int blockSize){
+	unsigned char header[PACKED_HEADER_SIZE] = { 0 };
+	PackedWriter * writer;
+
+	if (blockSize < 1 || (writer = calloc(1, sizeof(PackedWriter))) == NULL)
+		return NULL;
+
+	writer->outFile = outFile;
+	writer->header.flags = flags;
+	writer->header.blockSize = blockSize;
+	writer->offset = PACKED_HEADER_SIZE;
+
+	// Reserves room for the header, which is written once the counts are known
+	if ((writer->block = malloc(blockSize * PACKED_MAX_VARINT)) == NULL
+	    || fwrite(header, PACKED_HEADER_SIZE, 1, outFile) != 1){
+		free(writer->block);
+		free(writer);
+		return NULL;
+	}
+
+	return writer;
+}
+
+// Appends one int, returning -1 on failure
+int packedWrite(PackedWriter * writer, int value){
+	uint32_t zigzag;
+	uint32_t bits = (uint32_t)value;
+
+	// Encodes the difference from the previous int in delta mode
+	if (writer->header.flags & PACKED_DELTA){
+		bits -= (uint32_t)writer->previous;
+		writer->previous = value;
+	}
+
+	zigzag = (bits << 1) ^ -(bits >> 31);
+
+	// Writes seven bits per byte, setting the high bit on all but the last
+	while (zigzag >= 0x80){
+		writer->block[writer->blockBytes++] = (zigzag & 0x7f) | 0x80;
+		zigzag >>= 7;
+	}
+	writer->block[writer->blockBytes++] = zigzag;
+
+	if (++writer->blockInts == writer->header.blockSize)
+		return flushBlock(writer);
+
+	return 0;
+}
+
+// Writes the last block, the index, and the header, then frees writer.
+// Returns -1 on failure. Doesn't close the file.
+int packedClose(PackedWriter * writer){
+	unsigned char header[PACKED_HEADER_SIZE];
+	int result = 0;
+
+	if (writer->blockInts > 0 && flushBlock(writer) == -1) result = -1;
+
+	writer->header.indexOffset = writer->offset;
+
+	memcpy(header, PACKED_MAGIC, 4);
+	put32(header + 4, writer->header.flags);
+	put64(header + 8, writer->header.numInts);
+	put32(header + 16, writer->header.numBlocks);
+	put32(header + 20, writer->header.blockSize);
+	put64(header + 24, writer->header.indexOffset);
+
+	if (result == -1
+	    || fwrite(writer->index, PACKED_ENTRY_SIZE,
+		writer->header.numBlocks, writer->outFile)
+		!= writer->header.numBlocks
+	    || fseek(writer->outFile, 0, SEEK_SET) == -1
+	    || fwrite(header, PACKED_HEADER_SIZE, 1, writer->outFile) != 1)
+		result = -1;
+
+	free(writer->block);
+	free(writer->index);
+	free(writer);
+
+	return result;
+}
+
+// Writes the filled block and adds its index entry, returning -1 on failure
+static int flushBlock(PackedWriter * writer){
+	unsigned char * index;
+	unsigned char * entry;
+
+	index = realloc(writer->index,
+		(writer->header.numBlocks + 1) * PACKED_ENTRY_SIZE);
+	if (index == NULL) return -1;
+	writer->index = index;
+
+	entry = index + writer->header.numBlocks * PACKED_ENTRY_SIZE;
+	put64(entry, writer->offset);
+	put32(entry + 8, writer->blockInts);
+	put32(entry + 12, writer->blockBytes);
+
+	if (fwrite(writer->block, 1, writer->blockBytes, writer->outFile)
+		!= writer->blockBytes)
+		return -1;
+
+	// Starts the next block, whose deltas begin again from zero
+	writer->header.numBlocks++;
+	writer->header.numInts += writer->blockInts;
+	writer->offset += writer->blockBytes;
+	writer->blockInts = 0;
+	writer->blockBytes = 0;
+	writer->previous = 0;
+
+	return 0;
+}
+
+// Stores value in the four bytes at buff, least significant first
+static void put32(unsigned char * buff, uint32_t value){
+	int i;
+	for (i = 0; i < 4; i++) buff[i] = value >> (8 * i);
+}
+
+// Stores value in the eight bytes at buff, least significant first
+static void put64(unsigned char * buff, uint64_t value){
+	int i;
+	for (i = 0; i < 8; i++) buff[i] = value >> (8 * i);
+}
+
+// Reads the four bytes at buff, least significant first
+static uint32_t get32(unsigned char * buff){
+	return (uint32_t)buff[0] | (uint32_t)buff[1] << 8
+		| (uint32_t)buff[2] << 16 | (uint32_t)buff[3] << 24;
+}
+
+// Reads the eight bytes at buff, least significant first
+static uint64_t get64(unsigned char * buff){
+	return (uint64_t)get32(buff) | (uint64_t)get32(buff + 4) << 32;
+}
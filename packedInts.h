@@ -0,0 +1,60 @@
+// packedInts.h was created on 10/19/2026
+//
+// This file describes the packed integer file format and contains headers for
+// the functions in packedInts.c that write and decode it.
+//
+// A packed file starts with a PACKED_HEADER_SIZE byte header, followed by
+// blocks of zigzag varints and then an index with one entry per block. All
+// fields are little-endian.
+//
+//	Header:	"BINT", uint32 flags, uint64 numInts, uint32 numBlocks,
+//		uint32 blockSize, uint64 indexOffset
+//	Entry:	uint64 offset of the block, uint32 ints, uint32 bytes
+//
+// With PACKED_DELTA set, each int is stored as its difference from the one
+// before it in the same block, the first being relative to zero, so every
+// block can be decoded on its own.
+
+#ifndef PACKEDINTS_H
+#define PACKEDINTS_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define PACKED_MAGIC "BINT"		// First four bytes of a packed file
+#define PACKED_HEADER_SIZE 32		// Bytes in the header
+#define PACKED_ENTRY_SIZE 16		// Bytes per index entry
+#define PACKED_DELTA 1			// Flag: ints are delta-encoded
+#define PACKED_MAX_VARINT 5		// Max bytes in one 32-bit varint
+#define PACKED_BLOCK_SIZE 4096		// Default ints per block
+
+/* Parsed header of a packed file */
+typedef struct {
+	uint32_t flags;		// PACKED_DELTA or 0
+	uint64_t numInts;	// Total ints in the file
+	uint32_t numBlocks;	// Number of blocks and index entries
+	uint32_t blockSize;	// Max ints per block
+	uint64_t indexOffset;	// Offset of the first index entry
+} PackedHeader;
+
+/* State of a file being written one int at a time */
+typedef struct {
+	FILE * outFile;		// The packed file
+	PackedHeader header;	// Header, completed by packedClose
+	unsigned char * block;	// Varints of the block being filled
+	uint32_t blockInts;	// Ints in the block being filled
+	uint32_t blockBytes;	// Bytes in the block being filled
+	int32_t previous;	// Last int written, for delta encoding
+	unsigned char * index;	// Entries of the blocks written so far
+	uint64_t offset;	// Offset of the block being filled
+} PackedWriter;
+
+int readPackedHeader(FILE * inFile, PackedHeader * header);
+void decodePackedInts(FILE * inFile, PackedHeader * header, int * intArray,
+	int numThreads);
+
+PackedWriter * packedOpen(FILE * outFile, int flags, int blockSize);
+int packedWrite(PackedWriter * writer, int value);
+int packedClose(PackedWriter * writer);
+
+#endif
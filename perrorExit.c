@@ -5,13 +5,29 @@
 #include <unistd.h>
 #include <signal.h>
 
+#include "perrorExit.h"
+
 char * exeName;
+int quitOnError = 0;
 
 // This function prints an error message in a standard format and exits.
 void perrorExit(char * msg){
 	char errmsg[100];
+
+	// Standalone tools exit alone instead of interrupting their group
+	if (quitOnError) perrorQuit(msg);
+
 	sprintf(errmsg, "%s: Error: %s", exeName, msg);
 	perror(errmsg);
 
 	kill(0, SIGINT);
 }
+
+// Prints an error message in the same format and exits this process only
+void perrorQuit(char * msg){
+	char errmsg[100];
+	sprintf(errmsg, "%s: Error: %s", exeName, msg);
+	perror(errmsg);
+
+	exit(1);
+}
@@ -2,6 +2,12 @@
 //
 // This file contains a header for a function which outputs an error message
 // in a standard format using perror and then exits with error code 1.
+//
+// perrorExit interrupts the whole process group, so master and bin_adder clean
+// up together. Standalone tools call perrorQuit, which exits only the calling
+// process, and set quitOnError so shared code's perrorExit calls do the same.
 
 extern char * exeName;
+extern int quitOnError;
 void perrorExit(char * msg);
+void perrorQuit(char * msg);
@@ -1,53 +1,105 @@
 // randomTestGen.c was created by Mark Renard on 3/13/2020
-// 
+//
 // This file contains a program which writes NUM_INTS integers in the range
 // [MIN, MAX] to a file on consecutive new lines to be used as test
-// files by master
+// files by master, and prints their sum as a 64-bit integer
+//
+// The defaults can be changed with -n numInts, -l min, -u max, -o fileName,
+// and -s seed, so check.sh can generate inputs of any size and sign. -p writes
+// the packed format described in packedInts.h instead of text, and -d writes
+// it delta-encoded.
 //
 // If an argument is entered, the only int it prints is one.
 
 #include <time.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <unistd.h>
+
+#include "packedInts.h"
 
 const int NUM_INTS = 64;
 const int MIN = 0;		 // The minimum of the range of values of ints
 const int MAX = 255;		 // The maximum of the range of values of ints
 const char * FILE_NAME = "test"; // The name of the output file
 
-FILE * outFile;	// Pointer to the output file
+FILE * outFile;		// Pointer to the output file
+PackedWriter * writer;	// Writes packed ints if -p or -d is given
 
 int main(int argc, char * argv[]){
 	int randomInt;
-	int sum = 0;
-	
+	long long sum = 0;
+
+	int numInts = NUM_INTS;
+	int min = MIN;
+	int max = MAX;
+	const char * fileName = FILE_NAME;
+	unsigned int seed = (unsigned int) time(NULL);
+	int packed = 0;
+	int flags = 0;
+	int opt;
+
+	// Reads options overriding the defaults
+	while ((opt = getopt(argc, argv, "n:l:u:o:s:pd")) != -1){
+		switch (opt){
+		case 'n': numInts = atoi(optarg); break;
+		case 'l': min = atoi(optarg); break;
+		case 'u': max = atoi(optarg); break;
+		case 'o': fileName = optarg; break;
+		case 's': seed = (unsigned int) atoi(optarg); break;
+		case 'p': packed = 1; break;
+		case 'd': packed = 1; flags = PACKED_DELTA; break;
+		default:
+			fprintf(stderr, "Usage: %s [-n numInts] [-l min] "
+				"[-u max] [-o fileName] [-s seed] [-p] [-d] "
+				"[1]\n", argv[0]);
+			exit(1);
+		}
+	}
+
 	// Opens the output file in write mode
-	if ((outFile = fopen(FILE_NAME, "w+")) == NULL){
+	if ((outFile = fopen(fileName, "w+")) == NULL){
 		char buff[100];
 		sprintf(buff, "%s: Error: Couldn't open outFile", argv[0]);
 		perror(buff);
 		exit(1);
 	}
 
+	// Starts a packed file if requested
+	if (packed && (writer = packedOpen(outFile, flags, PACKED_BLOCK_SIZE))
+		== NULL){
+		fprintf(stderr, "%s: Error: Couldn't start packed file\n",
+			argv[0]);
+		exit(1);
+	}
+
 	// Seeds random number generator
-	srandom((unsigned int) time(NULL));
+	srandom(seed);
 
 	// Writes the integers
 	int i;
-	for (i = 0; i < NUM_INTS; i++){
+	for (i = 0; i < numInts; i++){
 
 		// Computes a random int, or 1 if there's an argument
-		randomInt = argc > 1 ? 1 \
-			 : random() % (MAX - MIN + 1) + MIN;
-		
+		randomInt = optind < argc ? 1 \
+			 : random() % (max - min + 1) + min;
+
 		// Prints the random int to the outfile
-		fprintf(outFile, "%d\n", randomInt);
+		if (packed) packedWrite(writer, randomInt);
+		else fprintf(outFile, "%d\n", randomInt);
 		sum += randomInt;
-	}	
+	}
+
+	// Writes the index and header of a packed file
+	if (packed && packedClose(writer) == -1){
+		fprintf(stderr, "%s: Error: Couldn't write packed file\n",
+			argv[0]);
+		exit(1);
+	}
 
 	fclose(outFile);
 
-	printf("Random int sum: %d\n", sum);
+	printf("Random int sum: %lld\n", sum);
 
 	return 0;
 }
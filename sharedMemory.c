@@ -3,7 +3,8 @@
 // This file contains an implementation of a function that returns a pointer
 // to a shared memory region of the requested size in bytes corresponding to
 // the key set in shmkey.h. If one does not exist and mask is set equal to
-// IPC_CREAT as defined in sys/ipc.h, one will be created.
+// IPC_CREAT as defined in sys/ipc.h, one will be created. The key can be
+// changed with setSharedMemoryKey so several masters can run on one host.
 
 #include <stdio.h>
 #include <unistd.h>
@@ -13,11 +14,17 @@
 #include "perrorExit.h"
 #include "shmkey.h"
 
-static int shmid; // The shmid of the shared memory region
+static int shmid;		// The shmid of the shared memory region
+static key_t key = SHMKEY;	// The key used by the next sharedMemory call
+
+// Sets the key used to create or find the shared memory region
+void setSharedMemoryKey(key_t newKey){
+	key = newKey;
+}
 
 // Returns a pointer to a new shared memory region
 char * sharedMemory(int size, int mask){
-	shmid = shmget ( SHMKEY, size, 0600 | mask );
+	shmid = shmget ( key, size, 0600 | mask );
 
 	// Prints error message and exits if unsuccessful
 	if (shmid == -1)
@@ -38,6 +45,15 @@ void removeSegment(){
 		perrorExit("removeSegment failed");
 }
 
+// Removes any segment with the current key, even one created by another
+// process, so the next sharedMemory call creates a fresh one
+void removeSegmentWithKey(){
+	int oldShmid = shmget(key, 0, 0600);
+
+	if (oldShmid != -1 && shmctl(oldShmid, IPC_RMID, NULL) == -1)
+		perrorExit("removeSegmentWithKey failed");
+}
+
 // Sets each byte in the shared memory region to the value of the byte parameter
 void initializeSharedMemory(char * shm, int bufferSize, char byte){
 	int i;
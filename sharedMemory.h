@@ -10,7 +10,9 @@
 
 char * sharedMemory(int size, int mask);
 void removeSegment();
+void removeSegmentWithKey();
 void detach(char * shm);
+void setSharedMemoryKey(key_t newKey);
 void initializeSharedMemory(char * shm, int bufferSize, char byte);
 
 #endif
@@ -0,0 +1,580 @@
+// simulate.c was created on 10/19/2026
+//
+// This file contains a discrete-event simulator which predicts how long master
+// takes to sum n integers without sleeping for real. Each level is divided
+// into groups by the same functions master and bin_adder use, and the parent
+// follows launchChildren's loop: it refills free slots after every wakeup,
+// wakes every SPECULATE_TICK_MS for straggler checks, backs up the groups the
+// policy in speculate.c picks, cancels the losing attempt once a group's
+// winner exits, and ends the level without waiting for losers. Every process
+// runs updateLogFile's five rounds of random sleep, lock wait, and critical
+// section on a virtual clock, and waiters acquire the lock in FIFO order. A
+// cancelled attempt exits at once if sleeping, skips its critical section if
+// waiting, and exits after it if holding the lock. Losers still running when
+// the parent exits are dropped rather than carried into the next level.
+//
+// Usage: simulate [-n ints] [-m method] [-r maxRunning] [-g groupSize]
+//		   [-s maxSleep] [-l minSleep] [-p preLogSleep] [-q postLogSleep]
+//		   [-t trials] [-x seed]
+//
+// -n, -r, -g, and -s also accept a range lo:hi, and a line is printed for
+// every combination, so thousands of configurations can be compared in one
+// run. -g replaces method 2's lg(n) group size on the first level and is
+// rejected for method 1. Each line gives the mean and worst makespan in
+// seconds over the trials, the mean fraction of the makespan during which the
+// log file lock was held, and the mean number of backups launched per run.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <limits.h>
+#include <math.h>
+#include <sys/time.h>
+
+#include "perrorExit.h"
+#include "constants.h"
+#include "levels.h"
+#include "speculate.h"
+
+/* Event types */
+#define READY 0		// Finished its random sleep, waits for the lock
+#define RELEASE 1	// Finished its critical section
+#define TICK 2		// The parent's wait timed out for a straggler check
+
+/* Process states */
+#define SLEEPING 0	// In the random sleep before waiting for the lock
+#define WAITING 1	// Queued for the lock
+#define HOLDING 2	// In the critical section
+#define EXITED 3	// Finished, or cancelled and gone
+
+/* Something that happens to one process at one virtual time */
+typedef struct {
+	double time;	// Virtual seconds since master started
+	long order;	// Breaks ties in the order events were scheduled
+	int proc;	// Index of the process, 0 being the parent bin_adder
+	int type;	// READY, RELEASE, or TICK
+} Event;
+
+/* A simulated bin_adder */
+typedef struct {
+	int group;	// Group it sums, or -1 for the parent
+	int rounds;	// Critical sections left
+	int state;	// SLEEPING, WAITING, HOLDING, or EXITED
+	int cancelled;	// 1 once another attempt at its group won
+} Process;
+
+/* A group summed by children, tracked as launchChildren tracks it */
+typedef struct {
+	double launched;	// Time the primary attempt was launched
+	int attempts[2];	// Running primary and backup, 0 when not running
+	int winner;		// Process whose sum was kept, or 0
+	int progress;		// Critical sections done by the furthest attempt
+	int backedUp;		// 1 once a backup has been launched
+	int done;		// 1 once the winner has exited
+} Group;
+
+/* Parameters of one simulated configuration */
+typedef struct {
+	int numInts;		// Integers in the input file
+	int method;		// Summation method, 1 or 2
+	int maxRunning;		// Max children of bin_adder
+	int groupSize;		// First-level group size, or 0 for the method's
+	int minSleep;		// Min random sleep before waiting for the lock
+	int maxSleep;		// Max random sleep before waiting for the lock
+	int preLogSleep;	// Sleep in the critical section before writing
+	int postLogSleep;	// Sleep in the critical section after writing
+} Config;
+
+/* Prototypes */
+static void parseRange(char * arg, int * lo, int * hi);
+static double simulateRun(Config * config, double * lockBusy, int * backups);
+static double simulateLevel(Config * config, int numGroups, double start,
+	double * lockBusy, int * backups);
+static void parentWake(Config * config, double now);
+static void launchAttempt(Config * config, int group, int attempt,
+	double now);
+static void cancelAttempt(Config * config, int proc, double now);
+static void processExit(Config * config, int proc, double now);
+static void acquire(Config * config, int proc, double now);
+static void schedule(double time, int proc, int type);
+static Event nextEvent();
+static int randomSleep(Config * config);
+
+/* Static Global Variables, reset for each level */
+static Event * heap = NULL;	// Binary min-heap of pending events
+static int heapSize = 0;	// Number of pending events
+static int heapCapacity = 0;	// Events the heap has room for
+static long scheduled = 0;	// Number of events ever scheduled
+static Process * procs = NULL;	// The parent, then attempts in launch order
+static int numProcs = 0;	// Processes launched, including the parent
+static int maxProcs = 0;	// Room in procs and waiters
+static Group * groups = NULL;	// Groups summed by children
+static int numChildren = 0;	// Groups summed by children
+static int * waiters = NULL;	// FIFO queue of processes waiting for lock
+static int waitHead = 0;	// Index of the first waiter
+static int waitTail = 0;	// Index after the last waiter
+static int lockHeld = 0;	// 1 while a process is in the critical section
+static double levelBusy = 0;	// Seconds the lock was held this level
+static int launched = 0;	// Groups launched so far
+static int finished = 0;	// Groups whose winner has exited
+static int oldest = 0;		// First group that may have a running attempt
+static int running = 0;		// Attempts launched but not yet exited
+static int backupsLaunched = 0;	// Backups launched this level
+static GroupTimes recent;	// Times of recently finished groups
+static long threshold = -1;	// stragglerThreshold of recent
+static int parentWaiting = 0;	// 1 while the parent blocks in reapChildren
+static long tickOrder = -1;	// Order of the TICK ending the current wait
+static double levelEnd = -1;	// Time the parent exits, once known
+
+int main(int argc, char * argv[]){
+	Config config;			// The configuration being simulated
+	int nLo = 64, nHi = 64;		// Range of numInts
+	int rLo = MAX_RUNNING, rHi = MAX_RUNNING; // Range of maxRunning
+	int gLo = 0, gHi = 0;		// Range of groupSize
+	int sLo = MAX_SLEEP, sHi = MAX_SLEEP;	// Range of maxSleep
+	int trials = 100;		// Runs averaged per configuration
+	int configs = 0;		// Configurations simulated
+	double makespan, worst, total;	// Makespans of each configuration
+	double lockBusy, utilization;	// Lock hold time and fraction
+	int backups, totalBackups;	// Backups launched in a run and in all
+	struct timeval start, end;	// Real time spent simulating
+	int opt, n, r, g, s, t;
+
+	exeName = argv[0];
+	quitOnError = 1;	// Exits alone, so scripted sweeps keep running
+	srandom(1);
+
+	config.method = 1;
+	config.minSleep = MIN_SLEEP;
+	config.preLogSleep = PRE_LOG_SLEEP;
+	config.postLogSleep = POST_LOG_SLEEP;
+
+	while ((opt = getopt(argc, argv, "n:m:r:g:s:l:p:q:t:x:")) != -1){
+		switch (opt){
+		case 'n': parseRange(optarg, &nLo, &nHi); break;
+		case 'm': config.method = atoi(optarg); break;
+		case 'r': parseRange(optarg, &rLo, &rHi); break;
+		case 'g': parseRange(optarg, &gLo, &gHi); break;
+		case 's': parseRange(optarg, &sLo, &sHi); break;
+		case 'l': config.minSleep = atoi(optarg); break;
+		case 'p': config.preLogSleep = atoi(optarg); break;
+		case 'q': config.postLogSleep = atoi(optarg); break;
+		case 't': trials = atoi(optarg); break;
+		case 'x': srandom(atoi(optarg)); break;
+		default:
+			errno = EINVAL;
+			perrorQuit("Unknown option, see simulate.c for usage");
+		}
+	}
+
+	// Rejects configurations the real programs can't run
+	if (nLo < 2 || rLo < 1 || (gHi > 0 && gLo < 2) || trials < 1
+	    || sLo < config.minSleep || config.minSleep < 0
+	    || (config.method != 1 && config.method != 2)){
+		errno = EINVAL;
+		perrorQuit("Invalid configuration");
+	}
+
+	// Rejects -g for method 1, whose groups are always pairs
+	if (gHi > 0 && config.method != 2){
+		errno = EINVAL;
+		perrorQuit("-g only applies to method 2");
+	}
+
+	gettimeofday(&start, NULL);
+
+	printf("ints method running group maxSleep pre post "
+		"makespan(s) worst(s) lockUtil backups\n");
+
+	// Simulates every combination of the ranges
+	for (n = nLo; n <= nHi; n++)
+	for (r = rLo; r <= rHi; r++)
+	for (g = gLo; g <= gHi; g++)
+	for (s = sLo; s <= sHi; s++){
+		config.numInts = n;
+		config.maxRunning = r;
+		config.groupSize = g;
+		config.maxSleep = s;
+
+		total = worst = utilization = 0;
+		totalBackups = 0;
+		for (t = 0; t < trials; t++){
+			makespan = simulateRun(&config, &lockBusy, &backups);
+			total += makespan;
+			totalBackups += backups;
+			if (makespan > worst) worst = makespan;
+			if (makespan > 0) utilization += lockBusy / makespan;
+		}
+
+		printf("%d %d %d %d %d %d %d %.1f %.1f %.3f %.2f\n",
+			n, config.method, r, g, s, config.preLogSleep,
+			config.postLogSleep, total / trials, worst,
+			utilization / trials, (double)totalBackups / trials
+		);
+		configs++;
+	}
+
+	gettimeofday(&end, NULL);
+	fprintf(stderr, "Simulated %d configurations in %ld ms\n", configs,
+		(end.tv_sec - start.tv_sec) * 1000
+		+ (end.tv_usec - start.tv_usec) / 1000
+	);
+
+	return 0;
+}
+
+// Reads "lo" or "lo:hi" into lo and hi
+static void parseRange(char * arg, int * lo, int * hi){
+	char * colon = strchr(arg, ':');
+
+	*lo = atoi(arg);
+	*hi = colon == NULL ? *lo : atoi(colon + 1);
+
+	if (*hi < *lo){
+		errno = EINVAL;
+		perrorQuit("Ranges must be given as lo:hi with lo <= hi");
+	}
+}
+
+// Simulates master's levels in order, returning the makespan in seconds,
+// adding the time the lock was held to lockBusy, and storing the number of
+// backups launched in backups
+static double simulateRun(Config * config, double * lockBusy, int * backups){
+	double now = 0;			// Virtual time
+	int intsToAdd = config->numInts;
+	int groups, groupSize;
+
+	*lockBusy = 0;
+	*backups = 0;
+
+	// Applies one iteration of method 2 if selected
+	if (config->method == 2){
+		if (config->groupSize > 0){
+			groupSize = config->groupSize;
+			groups = (intsToAdd + groupSize - 1) / groupSize;
+			now = simulateLevel(config, groups, now, lockBusy,
+				backups);
+			intsToAdd = groups;
+		} else {
+			groups = levelGroups(-2, intsToAdd, &groupSize);
+			now = simulateLevel(config, groups, now, lockBusy,
+				backups);
+			intsToAdd = nextLevelSize(-2, intsToAdd);
+		}
+	}
+
+	// Applies method 1 until a result is obtained
+	while (intsToAdd > 1){
+		groups = levelGroups(-1, intsToAdd, &groupSize);
+		now = simulateLevel(config, groups, now, lockBusy, backups);
+		intsToAdd = nextLevelSize(-1, intsToAdd);
+	}
+
+	return now;
+}
+
+// Simulates one parent bin_adder and its children, returning when it exits
+static double simulateLevel(Config * config, int numGroups, double start,
+	double * lockBusy, int * backups){
+	Event event;
+	Process * proc;
+	int i;
+
+	// Allocates room for the parent and a primary and backup per group
+	numChildren = numGroups - 1;
+	maxProcs = 1 + 2 * numChildren;
+	procs = realloc(procs, maxProcs * sizeof(Process));
+	waiters = realloc(waiters, maxProcs * sizeof(int));
+	groups = realloc(groups, (numChildren + 1) * sizeof(Group));
+	if (procs == NULL || waiters == NULL || groups == NULL)
+		perrorQuit("simulateLevel couldn't allocate memory");
+
+	heapSize = waitHead = waitTail = lockHeld = 0;
+	launched = finished = oldest = running = backupsLaunched = 0;
+	parentWaiting = 0;
+	recent.numTimes = 0;
+	threshold = -1;
+	levelBusy = 0;
+	levelEnd = -1;
+
+	for (i = 0; i < numChildren; i++){
+		groups[i].attempts[0] = groups[i].attempts[1] = 0;
+		groups[i].winner = groups[i].progress = 0;
+		groups[i].backedUp = groups[i].done = 0;
+	}
+
+	procs[0].group = -1;
+	procs[0].rounds = LOG_UPDATES;
+	procs[0].state = SLEEPING;
+	procs[0].cancelled = 0;
+	numProcs = 1;
+
+	parentWake(config, start);
+
+	while (levelEnd < 0){
+		event = nextEvent();
+		proc = &procs[event.proc];
+
+		// Resumes the parent if this TICK ends the wait it's in
+		if (event.type == TICK){
+			if (parentWaiting && event.order == tickOrder){
+				parentWaiting = 0;
+				parentWake(config, event.time);
+			}
+			continue;
+		}
+
+		// Takes the lock, or queues for it as pthread_mutex_lock blocks,
+		// unless cancelled while asleep
+		if (event.type == READY){
+			if (proc->state == EXITED) continue;
+
+			proc->state = WAITING;
+			if (lockHeld)
+				waiters[waitTail++ % maxProcs] = event.proc;
+			else
+				acquire(config, event.proc, event.time);
+			continue;
+		}
+
+		// Releases the lock and records the round as updateLogFile does
+		lockHeld = 0;
+		proc->rounds--;
+		if (proc->group >= 0 && groups[proc->group].winner == 0
+		    && groups[proc->group].progress < LOG_UPDATES - proc->rounds)
+			groups[proc->group].progress = LOG_UPDATES - proc->rounds;
+
+		if (proc->rounds > 0 && !proc->cancelled){
+			proc->state = SLEEPING;
+			schedule(event.time + randomSleep(config), event.proc,
+				READY);
+		} else {
+
+			// Publishes the sum unless cancelled or beaten
+			if (proc->group >= 0 && !proc->cancelled
+			    && groups[proc->group].winner == 0)
+				groups[proc->group].winner = event.proc;
+			processExit(config, event.proc, event.time);
+		}
+
+		// Hands the lock to the first waiter
+		if (waitHead < waitTail)
+			acquire(config, waiters[waitHead++ % maxProcs],
+				event.time);
+	}
+
+	*lockBusy += levelBusy;
+	*backups += backupsLaunched;
+	return levelEnd;
+}
+
+// Runs one pass of launchChildren's loop after the parent wakes: keeps
+// finished groups, cancels their losers, launches backups, refills free
+// slots, and waits again, or starts the parent's own log updates once every
+// group is done
+static void parentWake(Config * config, double now){
+	int timed = 0;		// 1 if a group was timed in this wakeup
+	double nextCheck = -1;	// Time the next group becomes a straggler
+	double ticks;		// SPECULATE_TICK_MS periods until it's seen
+	int i, attempt;
+
+	// Keeps each group whose winner has exited and cancels the loser
+	for (i = oldest; i < launched; i++){
+		if (groups[i].done || groups[i].winner == 0
+		    || procs[groups[i].winner].state != EXITED)
+			continue;
+
+		groups[i].done = 1;
+		finished++;
+		recordGroupTime(&recent, (now - groups[i].launched) * 1000);
+		timed = 1;
+
+		for (attempt = 0; attempt < 2; attempt++)
+			if (groups[i].attempts[attempt] != 0)
+				cancelAttempt(config,
+					groups[i].attempts[attempt], now);
+	}
+
+	// Skips past groups with nothing left running
+	while (oldest < launched && groups[oldest].done
+	    && groups[oldest].attempts[0] == 0
+	    && groups[oldest].attempts[1] == 0)
+		oldest++;
+
+	// Launches a backup for each straggling group while slots are free,
+	// sorting the group times again only when they've changed
+	if (timed) threshold = stragglerThreshold(&recent);
+	for (i = oldest; i < launched && running < config->maxRunning; i++){
+		if (groups[i].done || groups[i].backedUp
+		    || groups[i].attempts[0] == 0)
+			continue;
+
+		if (needsBackup(threshold, (now - groups[i].launched) * 1000,
+			groups[i].progress)){
+			launchAttempt(config, i, 1, now);
+			groups[i].backedUp = 1;
+			backupsLaunched++;
+
+		// Notes when the group becomes a straggler, if it ever can
+		} else if (needsBackup(threshold, LONG_MAX, groups[i].progress)
+		    && (nextCheck < 0
+			|| groups[i].launched + threshold / 1000.0 < nextCheck))
+			nextCheck = groups[i].launched + threshold / 1000.0;
+	}
+
+	// Leaves the loop once every group is done, without waiting for losers
+	if (finished == numChildren){
+		schedule(now + randomSleep(config), 0, READY);
+		return;
+	}
+
+	// Launches groups while fewer than maxRunning children run
+	while (launched < numChildren && running < config->maxRunning){
+		groups[launched].launched = now;
+		launchAttempt(config, launched, 0, now);
+		launched++;
+	}
+
+	// Waits for a child to exit, or until the first straggler check that
+	// finds a straggler, since the checks before it launch nothing
+	parentWaiting = 1;
+	if (nextCheck >= 0){
+		ticks = ceil((nextCheck - now) * 1000 / SPECULATE_TICK_MS);
+		tickOrder = scheduled;
+		schedule(now + (ticks < 1 ? 1 : ticks) * SPECULATE_TICK_MS
+			/ 1000.0, 0, TICK);
+	}
+}
+
+// Launches an attempt at group, which starts its first random sleep
+static void launchAttempt(Config * config, int group, int attempt,
+	double now){
+	int proc = numProcs++;
+
+	procs[proc].group = group;
+	procs[proc].rounds = LOG_UPDATES;
+	procs[proc].state = SLEEPING;
+	procs[proc].cancelled = 0;
+	groups[group].attempts[attempt] = proc;
+	running++;
+
+	schedule(now + randomSleep(config), proc, READY);
+}
+
+// Sends SIGTERM to a losing attempt. A sleeping attempt wakes and exits,
+// while one waiting for or holding the lock stops after releasing it.
+static void cancelAttempt(Config * config, int proc, double now){
+	procs[proc].cancelled = 1;
+
+	if (procs[proc].state == SLEEPING) processExit(config, proc, now);
+}
+
+// Reaps a finished process, waking the parent if it was waiting
+static void processExit(Config * config, int proc, double now){
+	int group = procs[proc].group;
+
+	procs[proc].state = EXITED;
+
+	if (proc == 0){
+		levelEnd = now;
+		return;
+	}
+
+	if (groups[group].attempts[0] == proc) groups[group].attempts[0] = 0;
+	if (groups[group].attempts[1] == proc) groups[group].attempts[1] = 0;
+	running--;
+
+	if (parentWaiting){
+		parentWaiting = 0;
+		parentWake(config, now);
+	}
+}
+
+// Gives proc the lock and schedules the end of its critical section, which a
+// cancelled attempt skips
+static void acquire(Config * config, int proc, double now){
+	double hold = procs[proc].cancelled
+		? 0 : config->preLogSleep + config->postLogSleep;
+
+	lockHeld = 1;
+	procs[proc].state = HOLDING;
+	levelBusy += hold;
+	schedule(now + hold, proc, RELEASE);
+}
+
+// Adds an event to the heap
+static void schedule(double time, int proc, int type){
+	Event event = { time, scheduled++, proc, type };
+	Event swap;
+	int child;
+	int parent;
+
+	// Grows the heap, which holds an event per process plus stale TICKs
+	if (heapSize == heapCapacity){
+		heapCapacity = heapCapacity == 0 ? 64 : 2 * heapCapacity;
+		if ((heap = realloc(heap, heapCapacity * sizeof(Event))) == NULL)
+			perrorQuit("schedule couldn't allocate memory");
+	}
+
+	child = heapSize++;
+	heap[child] = event;
+
+	// Sifts the event up past any later events
+	while (child > 0){
+		parent = (child - 1) / 2;
+		if (heap[parent].time < heap[child].time
+		    || (heap[parent].time == heap[child].time
+			&& heap[parent].order < heap[child].order))
+			break;
+
+		swap = heap[parent];
+		heap[parent] = heap[child];
+		heap[child] = swap;
+		child = parent;
+	}
+}
+
+// Removes and returns the earliest event, ties going to the first scheduled
+static Event nextEvent(){
+	Event first;
+	Event swap;
+	int parent = 0;
+	int child;
+
+	if (heapSize == 0){
+		errno = EDEADLK;
+		perrorQuit("nextEvent found no events before the level ended");
+	}
+
+	first = heap[0];
+	heap[0] = heap[--heapSize];
+
+	// Sifts the moved event down past any earlier events
+	while ((child = 2 * parent + 1) < heapSize){
+		if (child + 1 < heapSize
+		    && (heap[child + 1].time < heap[child].time
+			|| (heap[child + 1].time == heap[child].time
+			    && heap[child + 1].order < heap[child].order)))
+			child++;
+
+		if (heap[parent].time < heap[child].time
+		    || (heap[parent].time == heap[child].time
+			&& heap[parent].order < heap[child].order))
+			break;
+
+		swap = heap[parent];
+		heap[parent] = heap[child];
+		heap[child] = swap;
+		parent = child;
+	}
+
+	return first;
+}
+
+// Returns a random sleep in seconds as updateLogFile chooses it
+static int randomSleep(Config * config){
+	return random() % (config->maxSleep - config->minSleep + 1)
+		+ config->minSleep;
+}
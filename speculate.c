@@ -0,0 +1,53 @@
+// speculate.c was created on 10/19/2026
+//
+// This file contains the straggler policy shared by bin_adder and simulate, so
+// the simulator backs up the same groups launchChildren would.
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "constants.h"
+#include "speculate.h"
+
+/* Prototypes */
+static int compareLongs(const void * a, const void * b);
+
+// Records the ms a group took, dropping the oldest time once the window is full
+void recordGroupTime(GroupTimes * recent, long ms){
+	recent->times[recent->numTimes++ % SPECULATE_WINDOW] = ms;
+}
+
+// Returns SPECULATE_FACTOR times the SPECULATE_PERCENTILE of recent group
+// times, but at least SPECULATE_MIN_MS, or -1 until SPECULATE_MIN_SAMPLES
+// groups have been timed
+long stragglerThreshold(GroupTimes * recent){
+	long sorted[SPECULATE_WINDOW];
+	long threshold;
+	int count = recent->numTimes < SPECULATE_WINDOW
+		? recent->numTimes : SPECULATE_WINDOW;
+
+	if (recent->numTimes < SPECULATE_MIN_SAMPLES) return -1;
+
+	memcpy(sorted, recent->times, count * sizeof(long));
+	qsort(sorted, count, sizeof(long), compareLongs);
+
+	threshold = sorted[(count - 1) * SPECULATE_PERCENTILE / 100]
+		* SPECULATE_FACTOR;
+
+	return threshold > SPECULATE_MIN_MS ? threshold : SPECULATE_MIN_MS;
+}
+
+// Returns 1 if a group running for runningMs whose furthest attempt has done
+// progress critical sections should be backed up under threshold
+int needsBackup(long threshold, long runningMs, int progress){
+	return threshold >= 0 && runningMs >= threshold
+		&& progress < LOG_UPDATES - 1;
+}
+
+// Orders longs for qsort
+static int compareLongs(const void * a, const void * b){
+	long x = *(const long *)a;
+	long y = *(const long *)b;
+
+	return (x > y) - (x < y);
+}
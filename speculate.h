@@ -0,0 +1,21 @@
+// speculate.h was created on 10/19/2026
+//
+// This file contains headers for the functions in speculate.c, which decide
+// when a group summed by a child is a straggler that gets a backup.
+
+#ifndef SPECULATE_H
+#define SPECULATE_H
+
+#include "constants.h"
+
+/* Times of the groups that finished most recently */
+typedef struct {
+	long times[SPECULATE_WINDOW];	// Ms taken, oldest overwritten first
+	int numTimes;			// Number of groups ever timed
+} GroupTimes;
+
+void recordGroupTime(GroupTimes * recent, long ms);
+long stragglerThreshold(GroupTimes * recent);
+int needsBackup(long threshold, long runningMs, int progress);
+
+#endif
@@ -0,0 +1,34 @@
+// tasks.c was created on 10/19/2026
+//
+// This file contains the layout of master's shared memory region: the two
+// semaphores, the int array with room for the zero leftShiftInts appends, and
+// one TaskSlot per pair of ints, since groups summed by children always start
+// at least two ints apart. bin_adder only knows the region's size, so the
+// number of slots is recovered from it.
+
+#include <limits.h>
+#include <pthread.h>
+
+#include "tasks.h"
+
+// Returns the size in bytes of the shared memory region for numInts ints, or
+// -1 if it doesn't fit in the int master passes to bin_adder
+int sharedSize(unsigned int numInts){
+	size_t size = 2 * sizeof(pthread_mutex_t)
+		+ ((size_t)numInts + 1) * sizeof(int)
+		+ ((size_t)SLOT(numInts) + 1) * sizeof(TaskSlot);
+
+	return size > INT_MAX ? -1 : (int)size;
+}
+
+// Returns the first task slot in a region of shmSize bytes from sharedSize.
+// With numInts = 2k or 2k + 1, the ints and slots take k(2I + T) + I + T bytes
+// plus I more if numInts is odd, where I and T are their sizes, so dividing
+// by 2I + T recovers k.
+TaskSlot * taskSlots(char * shm, int shmSize){
+	size_t data = shmSize - 2 * sizeof(pthread_mutex_t);
+	size_t slots = (data - sizeof(int) - sizeof(TaskSlot))
+		/ (2 * sizeof(int) + sizeof(TaskSlot)) + 1;
+
+	return (TaskSlot *)(shm + shmSize - slots * sizeof(TaskSlot));
+}
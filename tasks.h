@@ -0,0 +1,29 @@
+// tasks.h was created on 10/19/2026
+//
+// This file contains the per-group task slots master places in shared memory
+// after the int array, and headers for the functions in tasks.c that size and
+// locate them. The slot for a group is SLOT of the index of its first int.
+
+#ifndef TASKS_H
+#define TASKS_H
+
+/* Value of an unclaimed slot in a level of the given size. Levels in a run
+   shrink, so each level's token differs from the one before it. */
+#define UNCLAIMED(level) (-(level))
+
+/* Slot of the group whose first int is at index. Groups children sum start at
+   least two ints apart, except in a method 2 level of two ints, whose only
+   child sums index 1. */
+#define SLOT(index) ((index) / 2)
+
+/* Progress of the attempts at summing one group */
+typedef struct {
+	volatile int winner;	// Pid of the attempt whose sum was kept, or
+				// UNCLAIMED(level) until one is
+	volatile int progress;	// Critical sections done by the furthest attempt
+} TaskSlot;
+
+int sharedSize(unsigned int numInts);
+TaskSlot * taskSlots(char * shm, int shmSize);
+
+#endif
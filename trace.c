@@ -0,0 +1,69 @@
+// trace.c was created on 10/19/2026
+//
+// This file contains functions that buffer binary trace records in memory
+// and append them to TRACE_LOG_NAME when the process exits. Recording an
+// event takes no lock and makes no system call other than clock_gettime.
+
+#ifdef TRACE
+
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdlib.h>
+
+#include "trace.h"
+#include "constants.h"
+
+static TraceRecord records[TRACE_CAPACITY];	// Buffered records
+static int numRecords = 0;			// Number of buffered records
+static pid_t owner = 0;				// Pid that owns the records
+
+// Empties the trace log, so it holds only the run that is starting
+void traceNewLog(){
+	int fd;
+
+	if ((fd = open(TRACE_LOG_NAME, O_WRONLY | O_CREAT | O_TRUNC, 0600)) != -1)
+		close(fd);
+}
+
+// Starts a trace for this process and flushes it when the process exits
+void traceInit(int index){
+	owner = getpid();
+	numRecords = 0;
+	atexit(traceFlush);
+	traceEvent(TRACE_START, index, TRACE_NO_LOCK);
+}
+
+// Buffers one record, flushing early only if the buffer is full
+void traceEvent(int event, int index, int lock){
+	struct timespec now;
+	TraceRecord * record;
+
+	if (numRecords == TRACE_CAPACITY) traceFlush();
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	record = &records[numRecords++];
+	record->ns = (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+	record->pid = owner;
+	record->index = index;
+	record->event = event;
+	record->lock = lock;
+}
+
+// Appends the buffered records to the trace log in a single write
+void traceFlush(){
+	int fd;
+
+	// Skips records inherited by a forked child that never called traceInit
+	if (numRecords == 0 || owner != getpid()) return;
+
+	if ((fd = open(TRACE_LOG_NAME, O_WRONLY | O_CREAT | O_APPEND, 0600)) != -1){
+		write(fd, records, numRecords * sizeof(TraceRecord));
+		close(fd);
+	}
+
+	numRecords = 0;
+}
+
+#endif
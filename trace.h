@@ -0,0 +1,50 @@
+// trace.h was created on 10/19/2026
+//
+// This file contains the binary trace record format and headers for the
+// functions in trace.c. When compiled with -DTRACE, master and bin_adder
+// record events in a per-process buffer which is written to TRACE_LOG_NAME
+// in one write when the process exits. master empties the log with
+// traceNewLog when a run starts. Otherwise the calls compile to nothing.
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+/* Event types */
+#define TRACE_START 1		// Process started, index is its index
+#define TRACE_WAIT 2		// Waiting for lock
+#define TRACE_ACQUIRE 3		// Acquired lock
+#define TRACE_RELEASE 4		// Released lock
+#define TRACE_LEVEL_BEGIN 5	// master launched a level, index is its size
+#define TRACE_LEVEL_END 6	// master reaped a level, index is its size
+
+/* Lock ids */
+#define TRACE_NO_LOCK 0
+#define TRACE_LOG_LOCK 1	// The semaphore protecting LOG_FILE_NAME
+
+/* Index recorded by master in its TRACE_START record */
+#define TRACE_MASTER_INDEX 0
+
+/* One fixed-size record, written in native byte order */
+typedef struct {
+	uint64_t ns;		// CLOCK_MONOTONIC time in nanoseconds
+	int32_t pid;		// Pid of the recording process
+	int32_t index;		// bin_adder index, or level size for master
+	uint16_t event;		// One of the event types above
+	uint16_t lock;		// One of the lock ids above
+} TraceRecord;
+
+#ifdef TRACE
+void traceNewLog();
+void traceInit(int index);
+void traceEvent(int event, int index, int lock);
+void traceFlush();
+#else
+#define traceNewLog()
+#define traceInit(index)
+#define traceEvent(event, index, lock)
+#define traceFlush()
+#endif
+
+#endif
@@ -0,0 +1,141 @@
+// traceToChrome.c was created on 10/19/2026
+//
+// This file contains a program which converts the binary trace written by
+// master and bin_adder when built with -DTRACE into Chrome trace event JSON,
+// which can be opened in chrome://tracing or ui.perfetto.dev.
+//
+// Usage: traceToChrome [traceFile [jsonFile]]
+//
+// Each process becomes a row. Time between TRACE_WAIT and TRACE_ACQUIRE is
+// shown as a "wait" slice and time holding a lock as a "hold" slice, so lock
+// convoys appear as staircases. master's levels are shown as slices on its
+// own row, so each level barrier is where one slice ends and the next begins.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "perrorExit.h"
+#include "constants.h"
+#include "trace.h"
+
+/* Prototypes */
+static void printRecord(FILE * outFile, TraceRecord * record, uint64_t base);
+static void printSlice(FILE * outFile, TraceRecord * record, uint64_t base,
+	char phase, char * name);
+static uint64_t earliestTime(FILE * inFile);
+
+static int numPrinted = 0;	// Number of JSON events printed so far
+
+int main(int argc, char * argv[]){
+	FILE * inFile;		// The binary trace
+	FILE * outFile;		// The JSON output
+	TraceRecord record;	// Each record read
+	uint64_t base;		// Earliest timestamp, shown as time zero
+
+	exeName = argv[0];
+	quitOnError = 1;	// Exits alone rather than stopping its caller
+
+	if ((inFile = fopen(argc > 1 ? argv[1] : TRACE_LOG_NAME, "rb")) == NULL)
+		perrorQuit("Couldn't open trace file");
+
+	if (argc > 2){
+		if ((outFile = fopen(argv[2], "w")) == NULL)
+			perrorQuit("Couldn't open output file");
+	} else {
+		outFile = stdout;
+	}
+
+	base = earliestTime(inFile);
+
+	fprintf(outFile, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	while (fread(&record, sizeof(TraceRecord), 1, inFile) == 1)
+		printRecord(outFile, &record, base);
+	fprintf(outFile, "\n]}\n");
+
+	if (ferror(inFile)) perrorQuit("Couldn't read trace file");
+
+	fclose(inFile);
+	if (outFile != stdout) fclose(outFile);
+
+	return 0;
+}
+
+// Returns the smallest timestamp in the trace and rewinds it
+static uint64_t earliestTime(FILE * inFile){
+	TraceRecord record;
+	uint64_t earliest = UINT64_MAX;
+
+	while (fread(&record, sizeof(TraceRecord), 1, inFile) == 1)
+		if (record.ns < earliest) earliest = record.ns;
+
+	rewind(inFile);
+	return earliest == UINT64_MAX ? 0 : earliest;
+}
+
+// Prints the JSON events corresponding to one record
+static void printRecord(FILE * outFile, TraceRecord * record, uint64_t base){
+	char name[BUFF_SZ];
+
+	switch (record->event){
+
+	// Names the process's row
+	case TRACE_START:
+		if (record->index == TRACE_MASTER_INDEX)
+			sprintf(name, "master");
+		else if (record->index < 0)
+			sprintf(name, "bin_adder %d (level parent)",
+				record->index);
+		else
+			sprintf(name, "bin_adder %d", record->index);
+
+		fprintf(outFile, "%s{\"name\":\"process_name\",\"ph\":\"M\","
+			"\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+			numPrinted++ ? ",\n" : "", record->pid, record->pid, name
+		);
+		printSlice(outFile, record, base, 'i', "start");
+		break;
+
+	// Waiting ends when the lock is acquired, and holding begins
+	case TRACE_WAIT:
+		sprintf(name, "wait lock %d", record->lock);
+		printSlice(outFile, record, base, 'B', name);
+		break;
+	case TRACE_ACQUIRE:
+		sprintf(name, "wait lock %d", record->lock);
+		printSlice(outFile, record, base, 'E', name);
+		sprintf(name, "hold lock %d", record->lock);
+		printSlice(outFile, record, base, 'B', name);
+		break;
+	case TRACE_RELEASE:
+		sprintf(name, "hold lock %d", record->lock);
+		printSlice(outFile, record, base, 'E', name);
+		break;
+
+	// Each level of master spans from launch to reaping
+	case TRACE_LEVEL_BEGIN:
+		sprintf(name, "level of %d ints", record->index);
+		printSlice(outFile, record, base, 'B', name);
+		break;
+	case TRACE_LEVEL_END:
+		sprintf(name, "level of %d ints", record->index);
+		printSlice(outFile, record, base, 'E', name);
+		break;
+
+	default:
+		fprintf(stderr, "%s: skipping unknown event %d\n", exeName,
+			record->event);
+	}
+}
+
+// Prints one event with phase B, E, or i at the record's time in microseconds
+static void printSlice(FILE * outFile, TraceRecord * record, uint64_t base,
+	char phase, char * name){
+
+	fprintf(outFile, "%s{\"name\":\"%s\",\"cat\":\"bin_adder\",\"ph\":\"%c\","
+		"\"ts\":%.3f,\"pid\":%d,\"tid\":%d%s}",
+		numPrinted++ ? ",\n" : "", name, phase,
+		(record->ns - base) / 1000.0, record->pid, record->pid,
+		phase == 'i' ? ",\"s\":\"t\"" : ""
+	);
+}